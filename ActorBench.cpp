@@ -0,0 +1,330 @@
+// Coroutine actors against thread-per-router, in two parts.
+// First a toy router: a single-destination distance-vector actor that
+// receives an offer, keeps it if it is cheaper, and passes the new cost on.
+// The coroutine version runs a million of them on one thread and reports the
+// memory held per suspended actor; both versions then run the same smaller
+// topology, and every result is checked against Dijkstra. These figures are
+// for the toy, not for the DVR engine.
+// Then the real engine: --actors against the threaded engine with one thread
+// per router, full tables for every destination, on one topology.
+#include "actors.hpp"
+#include "metrics.hpp"
+#include "threaded.hpp"
+#include "topology.hpp"
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <pthread.h>
+#include <queue>
+#include <thread>
+
+using namespace std;
+
+struct Link {
+    int to;
+    int cost;
+};
+
+// Adjacency in one array: the links of router r are links[first[r]..first[r + 1])
+struct Graph {
+    int N = 0;
+    vector<int> first;
+    vector<Link> links;
+
+    Graph(const vector<Edge>& edges, int N) : N(N), first(N + 2, 0), links(2 * edges.size()) {
+        for (const Edge& edge : edges) {
+            first[edge.src + 1]++;
+            first[edge.dest + 1]++;
+        }
+        for (int r = 1; r <= N + 1; ++r) first[r] += first[r - 1];
+        vector<int> fill(first.begin(), first.end() - 1);
+        for (const Edge& edge : edges) {
+            links[fill[edge.src]++] = {edge.dest, edge.cost};
+            links[fill[edge.dest]++] = {edge.src, edge.cost};
+        }
+    }
+};
+
+// Cost of reaching the destination through the sender
+struct Offer {
+    int from = 0;
+    int cost = 0;
+};
+
+static vector<int> dijkstra(const Graph& graph, int destination) {
+    vector<int> dist(graph.N + 1, INFINITY);
+    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> heap;
+    dist[destination] = 0;
+    heap.push({0, destination});
+    while (!heap.empty()) {
+        auto [d, r] = heap.top();
+        heap.pop();
+        if (d > dist[r]) continue;
+        for (int k = graph.first[r]; k < graph.first[r + 1]; ++k) {
+            const Link& link = graph.links[k];
+            if (d + link.cost < dist[link.to]) {
+                dist[link.to] = d + link.cost;
+                heap.push({dist[link.to], link.to});
+            }
+        }
+    }
+    return dist;
+}
+
+// ---- Toy router as coroutine actors ----
+
+struct CoroutineRun {
+    const Graph& graph;
+    Executor executor;
+    vector<ActorInbox<Offer>> inboxes;
+    vector<int> dist, next;
+    long long messages = 0;
+
+    explicit CoroutineRun(const Graph& graph)
+        : graph(graph), inboxes(graph.N + 1), dist(graph.N + 1, INFINITY), next(graph.N + 1, -1) {}
+
+    void advertise(int r) {
+        for (int k = graph.first[r]; k < graph.first[r + 1]; ++k) {
+            const Link& link = graph.links[k];
+            inboxes[link.to].send(Offer{r, dist[r] + link.cost}, executor);
+        }
+        messages += graph.first[r + 1] - graph.first[r];
+    }
+};
+
+static Actor router(CoroutineRun& run, int r) {
+    while (true) {
+        Offer offer = co_await run.inboxes[r].receive();
+        if (offer.cost < run.dist[r]) {
+            run.dist[r] = offer.cost;
+            run.next[r] = offer.from;
+            run.advertise(r);
+        }
+    }
+}
+
+// Creates one actor per router, lets them all suspend on their inboxes, then
+// starts the destination. Fills the timings and the frame bytes per actor.
+static void runCoroutines(CoroutineRun& run, int destination, double& spawnSeconds,
+                          double& runSeconds, double& framePerActor) {
+    int N = run.graph.N;
+    size_t framesBefore = Actor::promise_type::frameBytes;
+    auto start = chrono::steady_clock::now();
+    vector<Actor> actors;
+    actors.reserve(N);
+    for (int r = 1; r <= N; ++r) {
+        actors.push_back(router(run, r));
+        run.executor.schedule(actors.back().start());
+    }
+    run.executor.runWave();
+    spawnSeconds = secondsSince(start);
+    framePerActor = double(Actor::promise_type::frameBytes - framesBefore) / N;
+
+    start = chrono::steady_clock::now();
+    run.dist[destination] = 0;
+    run.next[destination] = destination;
+    run.advertise(destination);
+    while (run.executor.runWave() > 0) {
+    }
+    runSeconds = secondsSince(start);
+}
+
+// ---- Toy router, thread per router ----
+
+struct ThreadInbox {
+    mutex lock;
+    condition_variable ready;
+    deque<Offer> queue;
+};
+
+struct ThreadRun {
+    const Graph& graph;
+    vector<ThreadInbox> inboxes;
+    vector<int> dist, next;
+    atomic<long long> pending{0};     // Offers sent and not yet handled
+    atomic<long long> messages{0};
+    atomic<bool> finished{false};
+
+    explicit ThreadRun(const Graph& graph)
+        : graph(graph), inboxes(graph.N + 1), dist(graph.N + 1, INFINITY), next(graph.N + 1, -1) {}
+
+    void advertise(int r) {
+        int degree = graph.first[r + 1] - graph.first[r];
+        pending += degree;
+        messages += degree;
+        for (int k = graph.first[r]; k < graph.first[r + 1]; ++k) {
+            const Link& link = graph.links[k];
+            ThreadInbox& inbox = inboxes[link.to];
+            {
+                lock_guard<mutex> guard(inbox.lock);
+                inbox.queue.push_back(Offer{r, dist[r] + link.cost});
+            }
+            inbox.ready.notify_one();
+        }
+    }
+
+    // Wakes every thread once nothing is in flight
+    void finish() {
+        finished = true;
+        for (int r = 1; r <= graph.N; ++r) {
+            lock_guard<mutex> guard(inboxes[r].lock);
+            inboxes[r].ready.notify_one();
+        }
+    }
+
+    void router(int r) {
+        ThreadInbox& inbox = inboxes[r];
+        while (true) {
+            Offer offer;
+            {
+                unique_lock<mutex> guard(inbox.lock);
+                inbox.ready.wait(guard, [&] { return !inbox.queue.empty() || finished; });
+                if (inbox.queue.empty()) return;
+                offer = inbox.queue.front();
+                inbox.queue.pop_front();
+            }
+            // dist[r] is only written by this thread; senders read it before queueing
+            if (offer.cost < dist[r]) {
+                dist[r] = offer.cost;
+                next[r] = offer.from;
+                advertise(r);
+            }
+            if (--pending == 0) finish();
+        }
+    }
+};
+
+static bool runThreads(ThreadRun& run, int destination, double& spawnSeconds, double& runSeconds) {
+    int N = run.graph.N;
+    vector<thread> threads;
+    threads.reserve(N);
+    auto start = chrono::steady_clock::now();
+    try {
+        for (int r = 1; r <= N; ++r) {
+            threads.emplace_back(&ThreadRun::router, &run, r);
+        }
+    } catch (const system_error& error) {
+        cerr << "Could not start thread " << threads.size() + 1 << ": " << error.what() << "\n";
+        run.finish();
+        for (thread& worker : threads) worker.join();
+        return false;
+    }
+    spawnSeconds = secondsSince(start);
+
+    start = chrono::steady_clock::now();
+    run.dist[destination] = 0;
+    run.next[destination] = destination;
+    if (run.graph.first[destination + 1] == run.graph.first[destination]) {
+        run.finish();
+    } else {
+        run.advertise(destination);
+    }
+    for (thread& worker : threads) worker.join();
+    runSeconds = secondsSince(start);
+    return true;
+}
+
+// ---- The real engine ----
+
+// Runs the actors engine and the threaded engine with one thread per router on
+// the same topology. Returns false if their converged tables differ.
+static bool compareEngines(int N, uint64_t seed) {
+    vector<Edge> edges = randomTopology(N, 3 * N, 20, seed);
+    vector<Node> initial;
+    buildNodes(initial, edges, N);
+    MetricsRecorder metrics;
+    printf("\nDVR engine, full tables: %d routers, %zu links, method 1\n", N, edges.size());
+    printf("%-26s %8s %10s\n", "design", "steps", "run ms");
+
+    vector<Node> actorNodes = initial;
+    auto start = chrono::steady_clock::now();
+    int waves = runActors(actorNodes, N, 1, false, metrics);
+    double actorSeconds = secondsSince(start);
+    printf("%-26s %8d %10.2f  (executor waves)\n", "--actors", waves, actorSeconds * 1000);
+
+    vector<Node> threadNodes = initial;
+    start = chrono::steady_clock::now();
+    int rounds = runThreaded(threadNodes, N, 1, N, false, metrics);
+    double threadSeconds = secondsSince(start);
+    printf("%-26s %8d %10.2f  (rounds)\n", "--threads, one per router", rounds, threadSeconds * 1000);
+
+    bool agree = true;
+    for (int r = 1; r <= N && agree; ++r) {
+        agree = actorNodes[r].distanceVector == threadNodes[r].distanceVector;
+    }
+    printf("threads took %.0fx as long; tables %s\n", threadSeconds / actorSeconds,
+           agree ? "match" : "DIFFER");
+    return agree;
+}
+
+static int mismatches(const vector<int>& dist, const vector<int>& expected) {
+    int wrong = 0;
+    for (size_t r = 1; r < dist.size(); ++r) {
+        if (dist[r] != expected[r]) wrong++;
+    }
+    return wrong;
+}
+
+int main(int argc, char* argv[]) {
+    int actorRouters = argc > 1 ? atoi(argv[1]) : 1000000;
+    int threadRouters = argc > 2 ? atoi(argv[2]) : 1000;
+    uint64_t seed = argc > 3 ? strtoull(argv[3], nullptr, 10) : 1;
+    int engineRouters = argc > 4 ? atoi(argv[4]) : 200;
+    if (actorRouters < 2 || threadRouters < 2 || engineRouters < 2) {
+        cerr << "Usage: " << argv[0] << " [toy actor routers] [toy thread routers] [seed] [engine routers]\n";
+        return 1;
+    }
+
+    // A million suspended actors
+    Graph large(randomTopology(actorRouters, 3 * actorRouters, 20, seed), actorRouters);
+    double spawnSeconds, runSeconds, framePerActor;
+    int wrong;
+    {
+        CoroutineRun run(large);
+        runCoroutines(run, 1, spawnSeconds, runSeconds, framePerActor);
+        wrong = mismatches(run.dist, dijkstra(large, 1));
+        printf("Toy single-destination router: %d coroutine actors, %zu links, seed %llu\n",
+               actorRouters, large.links.size() / 2, (unsigned long long)seed);
+        printf("  spawned and suspended in %.1f ms (%.0f ns per actor)\n", spawnSeconds * 1000,
+               spawnSeconds * 1e9 / actorRouters);
+        // Besides its frame, a suspended actor holds its handle and an empty inbox
+        printf("  %.0f bytes per suspended actor (%.0f frame, %zu handle, %zu inbox)\n",
+               framePerActor + sizeof(Actor) + sizeof(ActorInbox<Offer>), framePerActor,
+               sizeof(Actor), sizeof(ActorInbox<Offer>));
+        printf("  converged in %.1f ms, %lld messages (%.0f per second), %d wrong costs\n\n",
+               runSeconds * 1000, run.messages, run.messages / runSeconds, wrong);
+    }
+
+    // The same topology for both designs
+    Graph small(randomTopology(threadRouters, 3 * threadRouters, 20, seed), threadRouters);
+    vector<int> expected = dijkstra(small, 1);
+    pthread_attr_t attributes;
+    size_t stackBytes = 0;
+    pthread_attr_init(&attributes);
+    pthread_attr_getstacksize(&attributes, &stackBytes);
+    pthread_attr_destroy(&attributes);
+
+    printf("Toy single-destination router: %d routers, %zu links\n", threadRouters, small.links.size() / 2);
+    printf("%-18s %10s %10s %12s %8s\n", "design", "spawn ms", "run ms", "messages", "wrong");
+    CoroutineRun coroutines(small);
+    double coroutineSpawn, coroutineRun;
+    runCoroutines(coroutines, 1, coroutineSpawn, coroutineRun, framePerActor);
+    int coroutineWrong = mismatches(coroutines.dist, expected);
+    printf("%-18s %10.2f %10.2f %12lld %8d\n", "coroutine actors", coroutineSpawn * 1000,
+           coroutineRun * 1000, coroutines.messages, coroutineWrong);
+
+    ThreadRun threads(small);
+    double threadSpawn, threadRun;
+    if (!runThreads(threads, 1, threadSpawn, threadRun)) return 1;
+    int threadWrong = mismatches(threads.dist, expected);
+    printf("%-18s %10.2f %10.2f %12lld %8d\n", "thread per router", threadSpawn * 1000,
+           threadRun * 1000, threads.messages.load(), threadWrong);
+    printf("threads took %.0fx as long; each reserves a %zu KB stack against %.0f bytes of frame\n",
+           (threadSpawn + threadRun) / (coroutineSpawn + coroutineRun), stackBytes / 1024,
+           framePerActor);
+
+    bool agree = compareEngines(engineRouters, seed);
+    return wrong + coroutineWrong + threadWrong == 0 && agree ? 0 : 1;
+}
@@ -0,0 +1,774 @@
+// Differential fuzzer: runs every engine on random topologies and random
+// link-failure sequences and checks the converged tables against
+//   - shortest paths, on the initial run (after a failure a router may keep a
+//     stale cost to a neighbour, since it never reads link costs again),
+//   - reference rounds over the map tables that build each advertisement with
+//     Part2's and Part3's filters and share no code with the engines: Jacobi
+//     or in-place rounds matched exactly, or for the actors a fixed point,
+//   - the parts' own updateDistanceVectors loop (exact, cost and next hop).
+// The original loop has documented quirks (see knownDivergence); a difference
+// they explain is reported but does not fail the run.
+// A mismatch is shrunk to a minimal case and printed in the parts' input format.
+#include "engine.hpp"
+#include "metrics.hpp"
+#include "options.hpp"
+#include "topology.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <csignal>
+#include <cstring>
+#include <functional>
+#include <sstream>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+
+// Seconds one case may take on one engine before it counts as a hang
+const int CASE_TIMEOUT = 10;
+
+// Rounds after which the original loop or the reference is taken to be stuck
+// (split horizon can count to infinity below the detection threshold forever)
+static int roundLimit(int N) {
+    return 20 * N + 4 * COUNT_TO_INFINITY_LIMIT;
+}
+
+// A topology, the links failed one after another, and the method
+struct FuzzCase {
+    int N = 0;
+    int method = 1;
+    vector<Edge> edges;
+    vector<pair<int, int>> failures;
+};
+
+// The updateDistanceVectors of Part1 (method 1), Part2 (2) and Part3 (3),
+// kept verbatim apart from the method switch and the lines marked "harness",
+// which count the comparisons that one of the loop's quirks won at some step
+// (later steps may pick another neighbour, but from a different minimum):
+//   - the other neighbours' rows are read unfiltered (methods 2 and 3),
+//   - a withheld split-horizon entry reads back as cost 0 (method 3).
+static bool originalUpdate(vector<Node>& nodes, int N, int method, int& quirkWins) {
+    vector<map<int, int>> oldDVs;
+    for(int i = 1; i <= N; i++){
+        oldDVs.push_back(nodes[i].distanceVector);
+    }
+
+    for (int i = 1; i <= N; ++i) {
+        for (int neighbor : nodes[i].neighbors) {
+            // For each neighbor, create a copy of the distance vector to send
+            map<int, int> dvToSend = nodes[i].distanceVector;
+
+            if (method == 2) {
+                // Poisoned Reverse
+                for (auto& entry : dvToSend) {
+                    int dest = entry.first;
+                    if (nodes[i].nextHop[dest] == neighbor && dest != neighbor) {
+                        dvToSend[dest] = INFINITY;
+                    }
+                }
+            } else if (method == 3) {
+                // Split Horizon
+                for (auto it = dvToSend.begin(); it != dvToSend.end();) {
+                    int dest = it->first;
+                    if (nodes[i].nextHop[dest] == neighbor && dest != neighbor) {
+                        // Remove the route from the advertisement
+                        it = dvToSend.erase(it);
+                    } else {
+                        ++it;
+                    }
+                }
+            }
+
+            // Need to store the old distance vector of the neigbor for calculations
+            map<int, int> oldDV = nodes[neighbor].distanceVector;
+
+            // Now, neighbor updates its distance vector based on the received dvToSend
+            for(int j = 1; j <= N; j++){
+                // Neighbor needs to update its distance vector for all enteries
+                if(neighbor == j) continue; // Skip its own entry
+
+                int minCost = INFINITY;
+                bool withheld = dvToSend.find(j) == dvToSend.end();   // harness
+                bool viaQuirk = false;                                 // harness
+                for(int neighborsNeighbor : nodes[neighbor].neighbors){
+                    // for all neighbors of this neighbor we need to find minimum for all destination nodes
+                    // except for i, for them we need to use the one supplied by dvToSend
+                    if(neighborsNeighbor == i){
+                        if((oldDV[neighborsNeighbor] + dvToSend[j]) < minCost){
+                            minCost = oldDV[neighborsNeighbor] + nodes[neighborsNeighbor].distanceVector[j];
+                            nodes[neighbor].distanceVector[j] = minCost;
+                            nodes[neighbor].nextHop[j] = neighborsNeighbor;
+                            viaQuirk = viaQuirk || withheld;                           // harness
+                        }
+                    }else{
+                        if((oldDV[neighborsNeighbor] + nodes[neighborsNeighbor].distanceVector[j]) < minCost){
+                            minCost = oldDV[neighborsNeighbor] + nodes[neighborsNeighbor].distanceVector[j];
+                            nodes[neighbor].distanceVector[j] = minCost;
+                            nodes[neighbor].nextHop[j] = neighborsNeighbor;
+                            viaQuirk = viaQuirk || (method != 1 && j != neighbor &&    // harness
+                                       nodes[neighborsNeighbor].nextHop[j] == neighbor);
+                        }
+                    }
+                }
+                if (viaQuirk) quirkWins++;                             // harness
+            }
+        }
+    }
+
+    // To decide whether updated or not
+    // we need to compare old distance vectors to new distance vectors
+    for(int i = 1; i <= N; i++){
+        for(int j = 1; j <= N; j++){
+            if(i == j) continue;
+            if(oldDVs[i - 1][j] != nodes[i].distanceVector[j]){
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// checkCountToInfinity without the report
+static bool overLimit(const vector<Node>& nodes, int N) {
+    for (int i = 1; i <= N; ++i) {
+        for (auto& entry : nodes[i].distanceVector) {
+            if (entry.second > COUNT_TO_INFINITY_LIMIT && entry.second < INFINITY) return true;
+        }
+    }
+    return false;
+}
+
+// Removes a link from the routers' state the way the parts' main does
+static void failLink(vector<Node>& nodes, int a, int b) {
+    nodes[a].neighbors.erase(remove(nodes[a].neighbors.begin(), nodes[a].neighbors.end(), b),
+                             nodes[a].neighbors.end());
+    nodes[b].neighbors.erase(remove(nodes[b].neighbors.begin(), nodes[b].neighbors.end(), a),
+                             nodes[b].neighbors.end());
+    nodes[a].distanceVector[b] = INFINITY;
+    nodes[b].distanceVector[a] = INFINITY;
+    nodes[a].nextHop[b] = -1;
+    nodes[b].nextHop[a] = -1;
+}
+
+// How one phase (initial convergence or one failure) ended
+enum Outcome {
+    CONVERGED,
+    COUNT_TO_INFINITY,   // Some cost passed the limit; the tables are not compared
+    STUCK,               // Original loop or reference only: no convergence within roundLimit
+    ENGINE_ERROR
+};
+
+static const char* outcomeName(Outcome outcome) {
+    switch (outcome) {
+    case CONVERGED: return "converged";
+    case COUNT_TO_INFINITY: return "count-to-infinity";
+    case STUCK: return "stuck";
+    default: return "error";
+    }
+}
+
+struct PhaseResult {
+    Outcome outcome = CONVERGED;
+    FlatTables tables;
+    int quirkWins = 0;     // Original loop: comparisons won through one of its quirks
+    FlatTables settled;    // Asynchronous engine: its tables after one more reference round
+};
+
+static string describeEntry(const char* kind, int i, int j, int expected, int got) {
+    ostringstream out;
+    out << kind << " of router " << i << " to " << j << ": expected " << expected << ", engine " << got;
+    return out.str();
+}
+
+static void finishPhase(PhaseResult& result, const vector<Node>& nodes, int N, bool afterFailure) {
+    if (result.outcome == CONVERGED && afterFailure && overLimit(nodes, N)) {
+        result.outcome = COUNT_TO_INFINITY;
+    }
+    result.tables.load(nodes, N);
+}
+
+static PhaseResult originalPhase(vector<Node>& nodes, int N, int method, bool afterFailure) {
+    PhaseResult result;
+    bool updated;
+    int rounds = 0;
+    do {
+        updated = originalUpdate(nodes, N, method, result.quirkWins);
+        if (afterFailure && overLimit(nodes, N)) break;
+    } while (updated && ++rounds < roundLimit(N));
+    if (updated && rounds >= roundLimit(N)) result.outcome = STUCK;
+    finishPhase(result, nodes, N, afterFailure);
+    return result;
+}
+
+// ---- Reference rounds ----
+// Plain map-based DVR written from the parts' advertisement filters. It does
+// not use relaxRouter or advertisedCost, so a bug in the engines' shared
+// kernel shows up as a difference.
+
+// What router `from` sends to neighbour `to`: its distance vector with a route
+// through `to` poisoned (Part2) or left out (Part3)
+static map<int, int> advertisement(const vector<Node>& nodes, int from, int to, int method) {
+    map<int, int> dv = nodes[from].distanceVector;
+    for (auto it = dv.begin(); it != dv.end();) {
+        int dest = it->first;
+        bool throughTo = nodes[from].nextHop.at(dest) == to && dest != to;
+        if (method == 2 && throughTo) {
+            it->second = INFINITY;
+            ++it;
+        } else if (method == 3 && throughTo) {
+            it = dv.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return dv;
+}
+
+// Router r's new routes from its neighbours' advertisements in `from`, written
+// to `to` (which may be `from` itself). Each destination takes the cheapest
+// finite offer, the first neighbour in list order on ties; with no finite
+// offer the old route stays. Returns true if a cost changed.
+static bool referenceRelax(const vector<Node>& from, vector<Node>& to, int r, int N, int method) {
+    const Node& self = from[r];
+    vector<map<int, int>> adverts;
+    for (int u : self.neighbors) adverts.push_back(advertisement(from, u, r, method));
+    map<int, int> dist = self.distanceVector, next = self.nextHop;
+    bool changed = false;
+    for (int j = 1; j <= N; ++j) {
+        if (j == r) continue;
+        int best = INFINITY;
+        for (size_t k = 0; k < self.neighbors.size(); ++k) {
+            auto offer = adverts[k].find(j);
+            if (offer == adverts[k].end()) continue;
+            int cost = self.distanceVector.at(self.neighbors[k]) + offer->second;
+            if (cost < best) {
+                best = cost;
+                dist[j] = cost;
+                next[j] = self.neighbors[k];
+            }
+        }
+        if (dist[j] != self.distanceVector.at(j)) changed = true;
+    }
+    to[r].distanceVector = dist;
+    to[r].nextHop = next;
+    return changed;
+}
+
+// One reference Jacobi round: every router reads the previous round
+static bool referenceRound(vector<Node>& nodes, int N, int method) {
+    vector<Node> previous = nodes;
+    bool changed = false;
+    for (int r = 1; r <= N; ++r) {
+        changed = referenceRelax(previous, nodes, r, N, method) || changed;
+    }
+    return changed;
+}
+
+// Reference rounds until nothing changes: Jacobi, or in place in the visit
+// order of a Gauss-Seidel sweep with the given seed
+static PhaseResult referencePhase(vector<Node>& nodes, int N, int method, bool inPlace,
+                                  uint64_t orderSeed, bool afterFailure) {
+    PhaseResult result;
+    XorShift64 rng(orderSeed);
+    vector<int> order;
+    for (int rounds = 1; ; ++rounds) {
+        bool changed = false;
+        if (inPlace) {
+            visitOrder(order, N, orderSeed ? &rng : nullptr);
+            for (int r : order) changed = referenceRelax(nodes, nodes, r, N, method) || changed;
+        } else {
+            changed = referenceRound(nodes, N, method);
+        }
+        if (!changed || (afterFailure && overLimit(nodes, N))) break;
+        if (rounds >= roundLimit(N)) {
+            result.outcome = STUCK;
+            break;
+        }
+    }
+    finishPhase(result, nodes, N, afterFailure);
+    return result;
+}
+
+// How an engine's rounds read the neighbours' rows, and so what it must match
+enum Reads {
+    READS_PREVIOUS_ROUND,   // Jacobi: the reference Jacobi rounds, exactly
+    READS_IN_PLACE,         // Gauss-Seidel: the reference in-place rounds in the same order, exactly
+    READS_ASYNC             // No rounds: converged tables must be a fixed point of a reference round
+};
+
+struct Engine {
+    string name;
+    SimOptions options;
+    Reads reads = READS_PREVIOUS_ROUND;
+};
+
+static PhaseResult enginePhase(vector<Node>& nodes, int N, int method, const Engine& engine,
+                               bool afterFailure) {
+    static MetricsRecorder metrics;
+    PhaseResult result;
+    if (runEngine(nodes, N, method, engine.options, afterFailure, metrics) < 0) {
+        result.outcome = ENGINE_ERROR;
+    }
+    finishPhase(result, nodes, N, afterFailure);
+    if (engine.reads == READS_ASYNC && result.outcome == CONVERGED) {
+        vector<Node> after = nodes;
+        referenceRound(after, N, method);
+        result.settled.load(after, N);
+    }
+    return result;
+}
+
+static vector<Engine> allEngines(const string& wirePrefix) {
+    vector<Engine> engines;
+    auto add = [&](const string& name, const string& engine, Reads reads) {
+        Engine e;
+        e.name = name;
+        e.options.engine = engine;
+        e.options.wirePrefix = wirePrefix;
+        e.reads = reads;
+        engines.push_back(e);
+        return &engines.back().options;
+    };
+    add("jacobi", "jacobi", READS_PREVIOUS_ROUND);
+    add("jacobi-2t", "jacobi", READS_PREVIOUS_ROUND)->threads = 2;
+    add("gauss-seidel", "gauss-seidel", READS_IN_PLACE);
+    add("gauss-seidel-shuffled", "gauss-seidel", READS_IN_PLACE)->orderSeed = 7;
+    add("threaded-2t", "threaded", READS_PREVIOUS_ROUND)->threads = 2;
+    add("partitioned-2p", "partitioned", READS_PREVIOUS_ROUND)->processes = 2;
+    add("wire", "wire", READS_PREVIOUS_ROUND);
+    add("ecmp-1", "ecmp", READS_PREVIOUS_ROUND);
+    add("actors", "actors", READS_ASYNC);
+    return engines;
+}
+
+// What an engine was found to disagree with
+enum MismatchKind {
+    NO_MISMATCH,
+    SHORTEST_PATHS,
+    REFERENCE,
+    ORIGINAL_LOOP,
+    ENGINE_FAILED    // The engine returned an error instead of tables
+};
+
+static const char* kindName(MismatchKind kind) {
+    switch (kind) {
+    case SHORTEST_PATHS: return "shortest paths";
+    case REFERENCE: return "the reference rounds";
+    case ENGINE_FAILED: return "engine failure";
+    default: return "the original loop";
+    }
+}
+
+// Differences from the original loop that are expected, and only those:
+//   - At methods 2 and 3 the loop is not the intended algorithm. It reads the
+//     neighbours other than the advertising one unfiltered, and under split
+//     horizon a withheld entry reads back through operator[] as cost 0 and
+//     wins the comparison. The engines reproduce neither, so a phase where the
+//     loop won a comparison that way may differ.
+//   - After a failure, the count-to-infinity stop fires on any transient cost
+//     over the limit. The loop updates in place, so its transient costs are
+//     not the engines', and one side may stop while the other converges.
+static bool knownDivergence(MismatchKind kind, int method, const PhaseResult& original,
+                            const PhaseResult& got) {
+    if (kind != ORIGINAL_LOOP) return false;
+    if (method != 1 && original.quirkWins > 0) return true;
+    bool oneStopped = (original.outcome == COUNT_TO_INFINITY) != (got.outcome == COUNT_TO_INFINITY);
+    return oneStopped && (original.outcome == CONVERGED || got.outcome == CONVERGED);
+}
+
+// First difference found over one case
+struct Mismatch {
+    MismatchKind kind = NO_MISMATCH;
+    bool known = false;          // A known divergence of the original loop
+    int phase = 0;               // 0 = initial convergence, k = after the k-th failure
+    string what;
+};
+
+// All-pairs shortest costs over the current links. The parts take the cost of
+// the last listed link between a pair, so parallel links do the same here.
+static vector<int> shortestPaths(int N, const vector<Edge>& edges) {
+    size_t row = N + 1;
+    vector<int> dist(row * row, INFINITY);
+    for (int i = 1; i <= N; ++i) dist[i * row + i] = 0;
+    for (const Edge& e : edges) {
+        dist[e.src * row + e.dest] = e.cost;
+        dist[e.dest * row + e.src] = e.cost;
+    }
+    for (int k = 1; k <= N; ++k) {
+        for (int i = 1; i <= N; ++i) {
+            for (int j = 1; j <= N; ++j) {
+                dist[i * row + j] = min(dist[i * row + j], dist[i * row + k] + dist[k * row + j]);
+            }
+        }
+    }
+    return dist;
+}
+
+// Compares two phase results; fills `what` and returns true on a difference
+static bool tablesDiffer(const PhaseResult& expected, const PhaseResult& got, int N,
+                         bool checkNextHops, const char* expectedName, string& what) {
+    if (got.outcome != expected.outcome) {
+        what = string(expectedName) + " " + outcomeName(expected.outcome) + ", engine " +
+               outcomeName(got.outcome);
+        return true;
+    }
+    if (expected.outcome != CONVERGED) return false;
+    for (int i = 1; i <= N; ++i) {
+        for (int j = 1; j <= N; ++j) {
+            int wantDist = expected.tables.distRow(i)[j], gotDist = got.tables.distRow(i)[j];
+            if (wantDist != gotDist) {
+                what = describeEntry("cost", i, j, wantDist, gotDist);
+                return true;
+            }
+            int wantNext = expected.tables.nextRow(i)[j], gotNext = got.tables.nextRow(i)[j];
+            if (checkNextHops && wantDist < INFINITY && wantNext != gotNext) {
+                what = describeEntry("next hop", i, j, wantNext, gotNext);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Runs every phase of a case (the initial convergence, then one per failure)
+// with `runPhase`. Stops after the first phase that does not converge.
+static vector<PhaseResult> runPhases(const FuzzCase& c,
+                                     const function<PhaseResult(vector<Node>&, bool)>& runPhase) {
+    vector<PhaseResult> phases;
+    vector<Node> nodes;
+    buildNodes(nodes, c.edges, c.N);
+    for (int phase = 0; phase <= (int)c.failures.size(); ++phase) {
+        if (phase > 0) failLink(nodes, c.failures[phase - 1].first, c.failures[phase - 1].second);
+        phases.push_back(runPhase(nodes, phase > 0));
+        if (phases.back().outcome != CONVERGED) break;
+    }
+    return phases;
+}
+
+// What the engines are checked against, computed once per case
+struct Oracle {
+    vector<PhaseResult> original;                  // The parts' own loop
+    vector<PhaseResult> previousRound;             // Reference Jacobi rounds
+    map<uint64_t, vector<PhaseResult>> inPlace;    // Reference in-place rounds, by order seed
+    vector<int> shortest;                          // Shortest costs before any failure
+};
+
+static Oracle buildOracle(const FuzzCase& c, const vector<Engine>& engines) {
+    Oracle oracle;
+    oracle.original = runPhases(c, [&](vector<Node>& nodes, bool afterFailure) {
+        return originalPhase(nodes, c.N, c.method, afterFailure);
+    });
+    oracle.previousRound = runPhases(c, [&](vector<Node>& nodes, bool afterFailure) {
+        return referencePhase(nodes, c.N, c.method, false, 0, afterFailure);
+    });
+    for (const Engine& engine : engines) {
+        uint64_t seed = engine.options.orderSeed;
+        if (engine.reads != READS_IN_PLACE || oracle.inPlace.count(seed)) continue;
+        oracle.inPlace[seed] = runPhases(c, [&](vector<Node>& nodes, bool afterFailure) {
+            return referencePhase(nodes, c.N, c.method, true, seed, afterFailure);
+        });
+    }
+    oracle.shortest = shortestPaths(c.N, c.edges);
+    return oracle;
+}
+
+// Runs a case on one engine and returns the first difference from the
+// oracle. The original loop is compared last, so a known divergence never
+// hides another mismatch. Phases after a count-to-infinity, or after the
+// original loop got stuck or diverged, are not compared with it.
+static Mismatch compareCase(const FuzzCase& c, const Engine& engine, const Oracle& oracle,
+                            bool checkNextHops) {
+    Mismatch mismatch, divergence;
+    vector<PhaseResult> phases = runPhases(c, [&](vector<Node>& nodes, bool afterFailure) {
+        return enginePhase(nodes, c.N, c.method, engine, afterFailure);
+    });
+    for (int phase = 0; phase < (int)phases.size(); ++phase) {
+        const PhaseResult& got = phases[phase];
+        mismatch.phase = phase;
+        if (got.outcome == ENGINE_ERROR) {
+            mismatch.kind = ENGINE_FAILED;
+            mismatch.what = "engine returned an error";
+            return mismatch;
+        }
+
+        if (phase == 0 && got.outcome == CONVERGED) {
+            int row = c.N + 1;
+            for (int i = 1; i <= c.N && mismatch.kind == NO_MISMATCH; ++i) {
+                for (int j = 1; j <= c.N; ++j) {
+                    if (got.tables.distRow(i)[j] != oracle.shortest[i * row + j]) {
+                        mismatch.kind = SHORTEST_PATHS;
+                        mismatch.what = describeEntry("cost", i, j, oracle.shortest[i * row + j],
+                                                      got.tables.distRow(i)[j]);
+                        break;
+                    }
+                }
+            }
+            if (mismatch.kind != NO_MISMATCH) return mismatch;
+        }
+
+        if (engine.reads == READS_ASYNC) {
+            // Converged tables must be a fixed point of the reference
+            PhaseResult fixedPoint;
+            fixedPoint.tables = got.settled;
+            if (got.outcome == CONVERGED &&
+                tablesDiffer(fixedPoint, got, c.N, checkNextHops, "a reference round", mismatch.what)) {
+                mismatch.kind = REFERENCE;
+                return mismatch;
+            }
+        } else {
+            // A reference run stops at its first unconverged phase, where the
+            // outcomes were already compared
+            const vector<PhaseResult>& reference = engine.reads == READS_IN_PLACE
+                ? oracle.inPlace.at(engine.options.orderSeed) : oracle.previousRound;
+            if (phase < (int)reference.size() && reference[phase].outcome != STUCK &&
+                tablesDiffer(reference[phase], got, c.N, checkNextHops, "reference", mismatch.what)) {
+                mismatch.kind = REFERENCE;
+                return mismatch;
+            }
+        }
+
+        if (divergence.kind == NO_MISMATCH && phase < (int)oracle.original.size()) {
+            const PhaseResult& expected = oracle.original[phase];
+            if (expected.outcome != STUCK && tablesDiffer(expected, got, c.N, checkNextHops, "original loop", mismatch.what)) {
+                mismatch.kind = ORIGINAL_LOOP;
+                if (!knownDivergence(ORIGINAL_LOOP, c.method, expected, got)) return mismatch;
+                mismatch.known = true;
+                // Keep checking the other oracles; report the divergence at the end
+                divergence = mismatch;
+                mismatch = Mismatch();
+            }
+        }
+    }
+    return divergence.kind != NO_MISMATCH ? divergence : Mismatch();
+}
+
+static FuzzCase randomCase(XorShift64& rng, int maxRouters) {
+    FuzzCase c;
+    c.N = 2 + rng.below(maxRouters - 1);
+    c.method = 1 + rng.below(3);
+    // Small cost ranges make ties, and with them next-hop choices, common
+    static const int costRanges[] = {1, 3, 20};
+    int maxCost = costRanges[rng.below(3)];
+    long long pairs = (long long)c.N * (c.N - 1) / 2;
+    int extra = rng.below(int(min<long long>(pairs, 2 * c.N)) + 1);
+
+    // Mostly connected (random spanning tree), sometimes not; parallel links allowed
+    if (rng.below(4) != 0) {
+        for (int v = 2; v <= c.N; ++v) {
+            c.edges.push_back({1 + rng.below(v - 1), v, 1 + rng.below(maxCost)});
+        }
+    }
+    for (int k = 0; k < extra; ++k) {
+        int a = 1 + rng.below(c.N), b = 1 + rng.below(c.N);
+        if (a != b) c.edges.push_back({a, b, 1 + rng.below(maxCost)});
+    }
+    if (c.edges.empty()) c.edges.push_back({1, 2, 1 + rng.below(maxCost)});
+
+    int failures = 1 + rng.below(3);
+    for (int k = 0; k < failures; ++k) {
+        const Edge& e = c.edges[rng.below(c.edges.size())];
+        c.failures.push_back({e.src, e.dest});
+    }
+    return c;
+}
+
+// Drops router `r`, its links and failures, and renumbers the routers above it
+static FuzzCase withoutRouter(const FuzzCase& c, int r) {
+    FuzzCase smaller = c;
+    smaller.N = c.N - 1;
+    smaller.edges.clear();
+    smaller.failures.clear();
+    auto renumber = [r](int v) { return v > r ? v - 1 : v; };
+    for (const Edge& e : c.edges) {
+        if (e.src != r && e.dest != r) smaller.edges.push_back({renumber(e.src), renumber(e.dest), e.cost});
+    }
+    for (auto& f : c.failures) {
+        if (f.first != r && f.second != r) smaller.failures.push_back({renumber(f.first), renumber(f.second)});
+    }
+    return smaller;
+}
+
+// Text printed if the current run hangs: set before every run, since the
+// alarm handler can only write out what is already formatted
+static string hangReport;
+// The terminal's stderr, kept open while the engines' stderr is discarded
+static int reportFd = STDERR_FILENO;
+
+static void onHang(int) {
+    ssize_t ignored = write(reportFd, hangReport.data(), hangReport.size());
+    (void)ignored;
+    _exit(2);
+}
+
+static string caseText(const FuzzCase& c) {
+    ostringstream out;
+    out << c.N << " " << c.edges.size() << "\n";
+    for (const Edge& e : c.edges) out << e.src << " " << e.dest << " " << e.cost << "\n";
+    for (auto& f : c.failures) out << f.first << " " << f.second << "\n";
+    return out.str();
+}
+
+// compareCase under a watchdog: an engine that never converges ends the run
+// with the case that hung
+static Mismatch watchedCompare(const FuzzCase& c, const Engine& engine, const Oracle& oracle,
+                               bool checkNextHops) {
+    hangReport = "HANG: " + engine.name + " did not finish within " + to_string(CASE_TIMEOUT) +
+                 " s at method " + to_string(c.method) + " on\n" + caseText(c);
+    alarm(CASE_TIMEOUT);
+    Mismatch mismatch = compareCase(c, engine, oracle, checkNextHops);
+    alarm(0);
+    return mismatch;
+}
+
+static Oracle watchedOracle(const FuzzCase& c, const vector<Engine>& engines) {
+    hangReport = "HANG: the original loop or the reference did not finish within " + to_string(CASE_TIMEOUT) +
+                 " s at method " + to_string(c.method) + " on\n" + caseText(c);
+    alarm(CASE_TIMEOUT);
+    Oracle oracle = buildOracle(c, engines);
+    alarm(0);
+    return oracle;
+}
+
+// Greedily removes routers, failures and links and lowers costs while the
+// engine still shows the same kind of mismatch
+static FuzzCase shrink(FuzzCase c, const Mismatch& found, const Engine& engine, bool checkNextHops) {
+    vector<Engine> only(1, engine);
+    auto stillFails = [&](const FuzzCase& candidate) {
+        if (candidate.N < 2 || candidate.edges.empty()) return false;
+        Oracle oracle = watchedOracle(candidate, only);
+        Mismatch mismatch = watchedCompare(candidate, engine, oracle, checkNextHops);
+        return mismatch.kind == found.kind && mismatch.known == found.known;
+    };
+    bool progress = true;
+    while (progress) {
+        progress = false;
+        for (int r = c.N; r >= 1; --r) {
+            FuzzCase smaller = withoutRouter(c, r);
+            if (stillFails(smaller)) { c = smaller; progress = true; }
+        }
+        for (int k = (int)c.failures.size() - 1; k >= 0; --k) {
+            FuzzCase smaller = c;
+            smaller.failures.erase(smaller.failures.begin() + k);
+            if (stillFails(smaller)) { c = smaller; progress = true; }
+        }
+        for (int k = (int)c.edges.size() - 1; k >= 0; --k) {
+            FuzzCase smaller = c;
+            smaller.edges.erase(smaller.edges.begin() + k);
+            if (stillFails(smaller)) { c = smaller; progress = true; }
+        }
+        for (size_t k = 0; k < c.edges.size(); ++k) {
+            for (int cost = 1; cost < c.edges[k].cost; ++cost) {
+                FuzzCase cheaper = c;
+                cheaper.edges[k].cost = cost;
+                if (stillFails(cheaper)) { c = cheaper; progress = true; break; }
+            }
+        }
+    }
+    return c;
+}
+
+// Prints a case in the parts' input format. The parts fail a single link, so
+// only a case with one failure can be replayed through them directly.
+static void printReproducer(const FuzzCase& c, const Engine& engine, const Mismatch& mismatch) {
+    cout << "Minimal case (method " << c.method << ", engine " << engine.name << ", "
+         << (mismatch.phase == 0 ? string("initial convergence") : "after failure " + to_string(mismatch.phase))
+         << (mismatch.kind == ENGINE_FAILED ? string(", ") : string(", against "))
+         << kindName(mismatch.kind)
+         << "): " << mismatch.what << "\n";
+    cout << caseText(c);
+    if (c.failures.size() == 1) {
+        cout << "(replays through ./bin/Part" << c.method << ", with and without the engine's options)\n";
+    }
+    cout << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    int cases = argc > 1 ? atoi(argv[1]) : 1000;
+    uint64_t seed = argc > 2 ? strtoull(argv[2], nullptr, 10) : 1;
+    int maxRouters = argc > 3 ? atoi(argv[3]) : 10;
+    bool checkNextHops = !(argc > 4 && strcmp(argv[4], "--costs-only") == 0);
+    if (cases < 1 || maxRouters < 2) {
+        cerr << "Usage: " << argv[0] << " [cases] [seed] [max routers] [--costs-only]\n";
+        return 1;
+    }
+
+    // Engines print reports (wire traffic, equal-cost routes) to stderr
+    int devNull = open("/dev/null", O_WRONLY);
+    reportFd = dup(STDERR_FILENO);
+    if (devNull < 0 || reportFd < 0) {
+        cerr << "Error opening /dev/null\n";
+        return 1;
+    }
+    auto silence = [&](bool on) {
+        cerr.flush();
+        dup2(on ? devNull : reportFd, STDERR_FILENO);
+    };
+
+    char dir[] = "/tmp/dvr-fuzz-XXXXXX";
+    if (mkdtemp(dir) == nullptr) {
+        cerr << "Error creating a scratch directory\n";
+        return 1;
+    }
+    vector<Engine> engines = allEngines(string(dir) + "/wire");
+    signal(SIGALRM, onHang);
+
+    XorShift64 rng(seed);
+    auto start = chrono::steady_clock::now();
+    // Cases per engine that fail a check, and that diverge from the original
+    // loop in a known way, by method
+    vector<int> failures(engines.size(), 0);
+    vector<vector<int>> divergences(engines.size(), vector<int>(4, 0));
+    bool failureShown = false;
+    vector<bool> divergenceShown(4, false);
+    for (int n = 0; n < cases; ++n) {
+        FuzzCase c = randomCase(rng, maxRouters);
+        silence(true);
+        Oracle oracle = watchedOracle(c, engines);
+        for (size_t e = 0; e < engines.size(); ++e) {
+            silence(true);
+            Mismatch mismatch = watchedCompare(c, engines[e], oracle, checkNextHops);
+            silence(false);
+            if (mismatch.kind == NO_MISMATCH) continue;
+
+            bool known = mismatch.known;
+            if (known) {
+                divergences[e][c.method]++;
+            } else {
+                failures[e]++;
+            }
+            // Shrink and show the first failure, and one divergence per method
+            if (known ? divergenceShown[c.method] : failureShown) continue;
+            silence(true);
+            FuzzCase minimal = shrink(c, mismatch, engines[e], checkNextHops);
+            Mismatch minimalMismatch = watchedCompare(minimal, engines[e],
+                                                      watchedOracle(minimal, vector<Engine>(1, engines[e])),
+                                                      checkNextHops);
+            silence(false);
+            cout << (known ? "Known divergence" : "FAILURE") << " in case " << n << " (seed " << seed
+                 << "): " << engines[e].name
+                 << (mismatch.kind == ENGINE_FAILED ? string(" failed to run")
+                                                    : string(" disagrees with ") + kindName(mismatch.kind))
+                 << "\n";
+            printReproducer(minimal, engines[e], minimalMismatch);
+            if (known) {
+                divergenceShown[c.method] = true;
+            } else {
+                failureShown = true;
+            }
+        }
+    }
+    double seconds = secondsSince(start);
+    string cleanup = string("rm -rf ") + dir;
+    if (system(cleanup.c_str()) != 0) cerr << "Could not remove " << dir << "\n";
+
+    printf("%-24s %10s %27s\n", "engine", "failures", "original loop m1 / m2 / m3");
+    int total = 0;
+    for (size_t e = 0; e < engines.size(); ++e) {
+        printf("%-24s %10d %15d / %d / %d\n", engines[e].name.c_str(), failures[e],
+               divergences[e][1], divergences[e][2], divergences[e][3]);
+        total += failures[e];
+    }
+    printf("%d cases x %zu engines in %.1f s (%.0f cases/min): %s\n", cases, engines.size(), seconds,
+           cases * 60 / seconds, total == 0 ? "all checks passed" : "FAILED");
+    return total == 0 ? 0 : 1;
+}
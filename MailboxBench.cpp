@@ -0,0 +1,237 @@
+// Stress benchmark for the per-link advertisement mailboxes.
+// Every thread broadcasts pooled advertisements to a fixed set of neighbour
+// threads and drains its own inboxes. The same traffic is then pushed through
+// queues guarded by one global mutex to show what the mailboxes avoid.
+// Finally the threaded engine itself runs on a random topology at 1, 2, 4, ...
+// threads, with the times its senders waited on the mailboxes.
+#include "mailbox.hpp"
+#include "metrics.hpp"
+#include "threaded.hpp"
+#include "topology.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+
+struct BenchConfig {
+    int threads = 64;
+    int links = 4;          // Outgoing links per thread
+    int adverts = 20000;    // Advertisements each thread broadcasts
+    int entries = 64;       // Distance vector length
+    int routers = 2000;     // Topology size for the threaded engine runs
+};
+
+struct BenchResult {
+    double seconds = 0;
+    long long handoffs = 0;
+    MailboxStalls stalls;        // Lock-free: sender waits on a buffer or a full mailbox
+    long long locks = 0;         // Mutex: lock acquisitions
+    long long contended = 0;     // Mutex: acquisitions that found the lock taken
+};
+
+static BenchResult runMailboxes(const BenchConfig& config) {
+    int T = config.threads;
+    vector<vector<unique_ptr<Mailbox>>> inbox(T);
+    vector<vector<Mailbox*>> outbox(T);
+    for (int t = 0; t < T; ++t) {
+        for (int k = 0; k < config.links; ++k) {
+            inbox[t].emplace_back(new Mailbox(8));
+        }
+    }
+    // Thread t sends to t+1 .. t+links; each of those owns one inbox for it
+    for (int t = 0; t < T; ++t) {
+        for (int k = 0; k < config.links; ++k) {
+            int to = (t + 1 + k) % T;
+            outbox[t].push_back(inbox[to][k].get());
+        }
+    }
+    // Pools outlive the threads: receivers may still hold a finished sender's buffers
+    vector<unique_ptr<AdvertPool>> pools(T);
+    for (int t = 0; t < T; ++t) {
+        pools[t].reset(new AdvertPool(16, config.entries));
+    }
+    vector<MailboxStalls> stalls(T);
+    vector<long long> received(T, 0), checksum(T, 0);
+
+    auto worker = [&](int t) {
+        AdvertPool& pool = *pools[t];
+        long long expected = (long long)config.adverts * config.links;
+        auto drain = [&]() {
+            for (auto& mailbox : inbox[t]) {
+                while (Advert* advert = mailbox->pop()) {
+                    checksum[t] += advert->dist[advert->round % config.entries];
+                    received[t]++;
+                    advert->release();
+                }
+            }
+        };
+        for (int sent = 0; sent < config.adverts; ++sent) {
+            Advert* advert;
+            while ((advert = pool.acquire(config.links)) == nullptr) {
+                stalls[t].poolWaits++;
+                drain();
+                this_thread::yield();
+            }
+            advert->round = sent;
+            advert->sender = t;
+            for (int j = 0; j <= config.entries; ++j) advert->dist[j] = sent + j;
+            for (Mailbox* mailbox : outbox[t]) {
+                while (!mailbox->push(advert)) {
+                    stalls[t].fullMailboxes++;
+                    drain();
+                    this_thread::yield();
+                }
+            }
+            drain();
+        }
+        while (received[t] < expected) {
+            drain();
+            this_thread::yield();
+        }
+    };
+
+    auto start = chrono::steady_clock::now();
+    vector<thread> pool;
+    for (int t = 0; t < T; ++t) pool.emplace_back(worker, t);
+    for (thread& th : pool) th.join();
+    BenchResult result;
+    result.seconds = secondsSince(start);
+    for (int t = 0; t < T; ++t) {
+        result.handoffs += received[t];
+        result.stalls.poolWaits += stalls[t].poolWaits;
+        result.stalls.fullMailboxes += stalls[t].fullMailboxes;
+    }
+    return result;
+}
+
+static BenchResult runGlobalMutex(const BenchConfig& config) {
+    int T = config.threads;
+    mutex lock;
+    vector<deque<shared_ptr<vector<int>>>> queues(T);
+    vector<long long> received(T, 0), checksum(T, 0), locks(T, 0), contended(T, 0);
+
+    auto acquire = [&](int t) {
+        locks[t]++;
+        if (!lock.try_lock()) {
+            contended[t]++;
+            lock.lock();
+        }
+    };
+
+    auto worker = [&](int t) {
+        long long expected = (long long)config.adverts * config.links;
+        auto drain = [&]() {
+            acquire(t);
+            while (!queues[t].empty()) {
+                checksum[t] += (*queues[t].front())[received[t] % config.entries];
+                queues[t].pop_front();
+                received[t]++;
+            }
+            lock.unlock();
+        };
+        for (int sent = 0; sent < config.adverts; ++sent) {
+            auto advert = make_shared<vector<int>>(config.entries + 1);
+            for (int j = 0; j <= config.entries; ++j) (*advert)[j] = sent + j;
+            acquire(t);
+            for (int k = 0; k < config.links; ++k) {
+                queues[(t + 1 + k) % T].push_back(advert);
+            }
+            lock.unlock();
+            drain();
+        }
+        while (received[t] < expected) {
+            drain();
+            this_thread::yield();
+        }
+    };
+
+    auto start = chrono::steady_clock::now();
+    vector<thread> pool;
+    for (int t = 0; t < T; ++t) pool.emplace_back(worker, t);
+    for (thread& th : pool) th.join();
+    BenchResult result;
+    result.seconds = secondsSince(start);
+    for (int t = 0; t < T; ++t) {
+        result.handoffs += received[t];
+        result.locks += locks[t];
+        result.contended += contended[t];
+    }
+    return result;
+}
+
+// Runs the threaded engine at 1, 2, 4, ... up to maxThreads threads on one
+// random topology and checks that every thread count gives the same tables
+static bool benchThreadedEngine(int N, int maxThreads) {
+    vector<Edge> edges = randomTopology(N, 3 * N, 20, 1);
+    vector<Node> initial;
+    buildNodes(initial, edges, N);
+    MetricsRecorder metrics;
+
+    cout << "\nThreaded engine: " << N << " routers, " << edges.size() << " links, seed 1\n";
+    printf("%7s %6s %10s %8s %10s %14s %14s %s\n", "threads", "rounds", "total ms", "speedup",
+           "pool waits", "full mailboxes", "barrier yields", "tables");
+    vector<Node> reference;
+    double baseSeconds = 0;
+    bool allMatch = true;
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        vector<Node> nodes = initial;
+        MailboxStalls stalls;
+        auto start = chrono::steady_clock::now();
+        int rounds = runThreaded(nodes, N, 1, threads, false, metrics, &stalls);
+        double seconds = secondsSince(start);
+        if (reference.empty()) {
+            reference = nodes;
+            baseSeconds = seconds;
+        }
+        bool agrees = true;
+        for (int i = 1; i <= N && agrees; ++i) {
+            agrees = nodes[i].distanceVector == reference[i].distanceVector &&
+                     nodes[i].nextHop == reference[i].nextHop;
+        }
+        allMatch = allMatch && agrees;
+        printf("%7d %6d %10.1f %7.2fx %10lld %14lld %14lld %s\n", threads, rounds, seconds * 1000,
+               baseSeconds / seconds, stalls.poolWaits, stalls.fullMailboxes, stalls.barrierYields,
+               agrees ? "match" : "DIFFER");
+    }
+    return allMatch;
+}
+
+int main(int argc, char* argv[]) {
+    BenchConfig config;
+    if (argc > 1) config.threads = atoi(argv[1]);
+    if (argc > 2) config.links = atoi(argv[2]);
+    if (argc > 3) config.adverts = atoi(argv[3]);
+    if (argc > 4) config.routers = atoi(argv[4]);
+    if (config.threads < 2 || config.links < 1 || config.links >= config.threads || config.adverts < 1 ||
+        config.routers < 2) {
+        cerr << "Usage: " << argv[0] << " [threads >= 2] [links < threads] [adverts] [routers >= 2]\n";
+        return 1;
+    }
+
+    cout << "Mailbox stress: " << config.threads << " threads, " << config.links
+         << " links each, " << config.adverts << " adverts per thread, "
+         << config.entries << "-entry vectors\n";
+
+    BenchResult lockFree = runMailboxes(config);
+    cout << "lock-free mailboxes:   " << (long long)(lockFree.handoffs / lockFree.seconds)
+         << " handoffs/s, " << lockFree.stalls.poolWaits << " pool waits, "
+         << lockFree.stalls.fullMailboxes << " full-mailbox waits\n";
+
+    BenchResult global = runGlobalMutex(config);
+    cout << "global mutex baseline: " << (long long)(global.handoffs / global.seconds)
+         << " handoffs/s, " << global.contended << " of " << global.locks
+         << " lock acquisitions contended\n";
+
+    // Speedup next to what each side waited on
+    printf("speedup %.2fx: %lld mailbox waits against %lld contended locks\n",
+           (lockFree.handoffs / lockFree.seconds) / (global.handoffs / global.seconds),
+           lockFree.stalls.poolWaits + lockFree.stalls.fullMailboxes, global.contended);
+
+    return benchThreadedEngine(config.routers, config.threads) ? 0 : 1;
+}
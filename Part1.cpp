@@ -1,4 +1,10 @@
 #include "defs.hpp"
+#include "checkpoint.hpp"
+#include "engine.hpp"
+#include "metrics.hpp"
+#include "options.hpp"
+#include "partition.hpp"
+#include "routes.hpp"
 
 using namespace std;
 
@@ -9,42 +15,100 @@ void initializeDistanceVectors(vector<Node>& nodes, vector<Edge>& edges, int N);
 
 
 
-int main() {
-    // Inputting number of routers and number of links
-    int N, M;
-    cin >> N >> M;
-
-    // Inputting edges and their costs
-    vector<Edge> edges(M);
-    for (int i = 0; i < M; ++i) {
-        cin >> edges[i].src >> edges[i].dest >> edges[i].cost;
+int main(int argc, char* argv[]) {
+    SimOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        return 1;
+    }
+    MetricsRecorder metrics;
+    if (!metrics.open(options.metricsPath, options.progress)) {
+        return 1;
     }
 
     int method = 1; // No error correction method
 
+    int N, M;
+    vector<Edge> edges;
     vector<Node> nodes;
-    initializeNodes(nodes, edges, N);
-    initializeDistanceVectors(nodes, edges, N);
+    bool resumed = !options.loadCheckpoint.empty();
+    // The partitioned engine keeps the tables in its worker processes from the
+    // start, so this process only ever holds the topology
+    bool streamed = options.engine == "partitioned" && !resumed && options.saveCheckpoint.empty();
+    PartitionedTables workers;
+    if (resumed) {
+        // Start from converged tables instead of reading a topology
+        if (!loadCheckpoint(options.loadCheckpoint, method, nodes, edges, N)) {
+            return 1;
+        }
+    } else {
+        // Inputting number of routers and number of links
+        cin >> N >> M;
+
+        // Inputting edges and their costs
+        edges.resize(M);
+        for (int i = 0; i < M; ++i) {
+            cin >> edges[i].src >> edges[i].dest >> edges[i].cost;
+        }
+
+        initializeNodes(nodes, edges, N);
+        if (!streamed) {
+            initializeDistanceVectors(nodes, edges, N);
+        }
+    }
+    RowSource tables = streamed ? workers.rows() : mapRows(nodes, N);
 
     // Run the DVR algorithm until convergence
     bool updated;
     int iteration = 0; // Iteration counter
-    do {
-        updated = updateDistanceVectors(nodes, N, method);
+    if (resumed) {
+        // The checkpoint already holds converged tables
+    } else if (options.engine != "sweep") {
+        // Alternative engine: only the converged vectors are written out
+        if (streamed) {
+            metrics.beginPhase("initial");
+            if (!workers.start(nodes, edges, N, method, options.processes)) {
+                return 1;
+            }
+            iteration = workers.converge(false, metrics);
+        } else {
+            metrics.beginPhase("initial", nodes, N);
+            iteration = runEngine(nodes, N, method, options, false, metrics);
+        }
+        if (iteration < 0) {
+            return 1;
+        }
+        printDistanceVectorsToFile(tables, N, "distance_vectors_iteration_" + to_string(iteration) + ".txt");
+    } else {
+        metrics.beginPhase("initial", nodes, N);
+        long long messages = advertisementsPerRound(nodes, N);
+        do {
+            auto start = chrono::steady_clock::now();
+            updated = updateDistanceVectors(nodes, N, method);
+            metrics.recordNodes(nodes, N, messages, secondsSince(start));
+
+            // Increment iteration counter
+            iteration++;
 
-        // Increment iteration counter
-        iteration++;
+            // Generate filename
+            string filename = "distance_vectors_iteration_" + to_string(iteration) + ".txt";
 
-        // Generate filename
-        string filename = "distance_vectors_iteration_" + to_string(iteration) + ".txt";
+            // Print the current distance vectors to file
+            printDistanceVectorsToFile(nodes, N, filename);
 
-        // Print the current distance vectors to file
-        printDistanceVectorsToFile(nodes, N, filename);
+        } while (updated);
+    }
+    metrics.endPhase();
 
-    } while (updated);
+    if (!options.saveCheckpoint.empty() && !saveCheckpoint(options.saveCheckpoint, nodes, edges, N, method)) {
+        return 1;
+    }
 
     cout << "\nRouting tables after running DVR algorithm:\n";
-    printRoutingTables(nodes, N);
+    if (streamed) {
+        printRoutingTables(tables, N, options.routers);
+    } else {
+        printRoutingTables(nodes, N, options.routers);
+    }
 
     // Simulate link failure
     int failSrc, failDest;
@@ -66,32 +130,65 @@ int main() {
     nodes[failDest].neighbors.erase(remove(nodes[failDest].neighbors.begin(), nodes[failDest].neighbors.end(), failSrc),
                                     nodes[failDest].neighbors.end());
 
-    nodes[failSrc].distanceVector[failDest] = INFINITY;
-    nodes[failDest].distanceVector[failSrc] = INFINITY;
-    nodes[failSrc].nextHop[failDest] = -1;
-    nodes[failDest].nextHop[failSrc] = -1;
+    if (streamed) {
+        // The routes of both ends live in the workers
+        if (!workers.failLink(failSrc, failDest)) {
+            return 1;
+        }
+    } else {
+        nodes[failSrc].distanceVector[failDest] = INFINITY;
+        nodes[failDest].distanceVector[failSrc] = INFINITY;
+        nodes[failSrc].nextHop[failDest] = -1;
+        nodes[failDest].nextHop[failSrc] = -1;
+    }
 
     // Re-run the DVR algorithm until convergence or until any distance exceeds 100
     bool countToInfinity = false;
     iteration = 0; // Reset iteration counter
-    do {
-        updated = updateDistanceVectors(nodes, N, method);
-        countToInfinity = checkCountToInfinity(nodes, N);
+    if (streamed) {
+        metrics.beginPhase("after_failure");
+    } else {
+        metrics.beginPhase("after_failure", nodes, N);
+    }
+    if (options.engine != "sweep") {
+        if (streamed) {
+            iteration = workers.converge(true, metrics);
+        } else {
+            iteration = runEngine(nodes, N, method, options, true, metrics);
+        }
+        if (iteration < 0) {
+            return 1;
+        }
+        countToInfinity = checkCountToInfinity(tables, N);
         if (countToInfinity) {
             cout << "Count-to-infinity problem detected.\n";
-            break;
+        } else {
+            printDistanceVectorsToFile(tables, N, "distance_vectors_after_failure_iteration_" + to_string(iteration) + ".txt");
         }
+    } else {
+        long long messages = advertisementsPerRound(nodes, N);
+        do {
+            auto start = chrono::steady_clock::now();
+            updated = updateDistanceVectors(nodes, N, method);
+            metrics.recordNodes(nodes, N, messages, secondsSince(start));
+            countToInfinity = checkCountToInfinity(nodes, N);
+            if (countToInfinity) {
+                cout << "Count-to-infinity problem detected.\n";
+                break;
+            }
 
-        // Increment iteration counter
-        iteration++;
+            // Increment iteration counter
+            iteration++;
 
-        // Generate filename
-        string filename = "distance_vectors_after_failure_iteration_" + to_string(iteration) + ".txt";
+            // Generate filename
+            string filename = "distance_vectors_after_failure_iteration_" + to_string(iteration) + ".txt";
 
-        // Print the current distance vectors to file
-        printDistanceVectorsToFile(nodes, N, filename);
+            // Print the current distance vectors to file
+            printDistanceVectorsToFile(nodes, N, filename);
 
-    } while (updated);
+        } while (updated);
+    }
+    metrics.endPhase();
 
     cout << "\nRouting tables after link failure";
     if (method == 2) {
@@ -100,7 +197,15 @@ int main() {
         cout << " with Split Horizon";
     }
     cout << ":\n";
-    printRoutingTables(nodes, N);
+    if (streamed) {
+        printRoutingTables(tables, N, options.routers);
+        // Also reports a worker that failed while its rows were being printed
+        if (!workers.stop()) {
+            return 1;
+        }
+    } else {
+        printRoutingTables(nodes, N, options.routers);
+    }
 
     return 0;
 }
@@ -196,34 +301,33 @@ bool updateDistanceVectors(vector<Node>& nodes, int N, int method) {
     return false;
 }
 
-void printRoutingTables(const vector<Node>& nodes, int N) {
-    for (int i = 1; i <= N; ++i) {
-        cout << "Routing table for Node " << i << ":\n";
-        cout << "Destination\tCost\tNext Hop\n";
-        for (int j = 1; j <= N; ++j) {
-            if (nodes[i].distanceVector.at(j) >= INFINITY) {
-                cout << j << "\t\t"
-                     << "INF"
-                     << "\t"
-                     << "-\n";
-            } else {
-                cout << j << "\t\t" << nodes[i].distanceVector.at(j) << "\t" << nodes[i].nextHop.at(j) << "\n";
-            }
-        }
-        cout << "\n";
-    }
+void printRoutingTables(const vector<Node>& nodes, int N, const RouterRanges& routers) {
+    // Format from the maps one router at a time and hand the dump to stdout in bulk
+    cout.flush();
+    OutputBuffer out(STDOUT_FILENO);
+    writeRoutingTables(nodes, N, routers, out);
+}
+
+void printRoutingTables(const RowSource& tables, int N, const RouterRanges& routers) {
+    cout.flush();
+    OutputBuffer out(STDOUT_FILENO);
+    writeRoutingTables(tables, N, routers, out);
 }
 
 bool checkCountToInfinity(const vector<Node>& nodes, int N) {
+    return checkCountToInfinity(mapRows(nodes, N), N);
+}
+
+bool checkCountToInfinity(const RowSource& tables, int N) {
     bool countToInfinity = false;
-    for (int i = 1; i <= N; ++i) {
-        for (auto& entry : nodes[i].distanceVector) {
-            if (entry.second > 100 && entry.second < INFINITY) {
-                cout << "Node " << i << " has distance >100 to Node " << entry.first << ".\n";
+    tables([&](int i, const int* dist, const int*) {
+        for (int j = 1; j <= N; ++j) {
+            if (dist[j] > 100 && dist[j] < INFINITY) {
+                cout << "Node " << i << " has distance >100 to Node " << j << ".\n";
                 countToInfinity = true;
             }
         }
-    }
+    });
     return countToInfinity;
 }
 
@@ -248,6 +352,10 @@ void createDirectoryIfNotExists(const std::string& dirName) {
 
 // Modified function to print distance vectors to a file in matrix form in "Part1" folder
 void printDistanceVectorsToFile(const vector<Node>& nodes, int N, const string& filename) {
+    printDistanceVectorsToFile(mapRows(nodes, N), N, filename);
+}
+
+void printDistanceVectorsToFile(const RowSource& tables, int N, const string& filename) {
     // Ensure the directory "Part1" exists
     createDirectoryIfNotExists("Part1");
 
@@ -268,17 +376,17 @@ void printDistanceVectorsToFile(const vector<Node>& nodes, int N, const string&
     outFile << "\n";
 
     // For each node, print its distance vector
-    for (int i = 1; i <= N; ++i) {
+    tables([&](int i, const int* dist, const int*) {
         outFile << i << "\t";
         for (int j = 1; j <= N; ++j) {
-            if (nodes[i].distanceVector.at(j) >= INFINITY) {
+            if (dist[j] >= INFINITY) {
                 outFile << "INF\t";
             } else {
-                outFile << nodes[i].distanceVector.at(j) << "\t";
+                outFile << dist[j] << "\t";
             }
         }
         outFile << "\n";
-    }
+    });
 
     outFile.close();
 }
\ No newline at end of file
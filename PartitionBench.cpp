@@ -0,0 +1,55 @@
+// Times the partitioned engine at 1, 2, 4, ... worker processes on one random
+// topology, and checks that every process count converges to the same tables.
+#include "metrics.hpp"
+#include "partition.hpp"
+#include "topology.hpp"
+#include <cstdio>
+#include <cstdlib>
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    int N = argc > 1 ? atoi(argv[1]) : 1000;
+    int M = argc > 2 ? atoi(argv[2]) : 3 * N;
+    uint64_t seed = argc > 3 ? strtoull(argv[3], nullptr, 10) : 1;
+    int maxProcesses = argc > 4 ? atoi(argv[4]) : 8;
+    if (N < 2 || maxProcesses < 1) {
+        cerr << "Usage: " << argv[0] << " [routers] [links] [seed] [max processes]\n";
+        return 1;
+    }
+
+    vector<Edge> edges = randomTopology(N, M, 20, seed);
+    vector<Node> initial;
+    buildNodes(initial, edges, N);
+    MetricsRecorder metrics;
+
+    cout << "Partitioned engine: " << N << " routers, " << edges.size() << " links, seed " << seed << "\n";
+    printf("%9s %9s %6s %10s %10s %8s %s\n",
+           "processes", "cut links", "rounds", "ms/round", "total ms", "speedup", "tables");
+
+    vector<Node> reference;
+    double baseSeconds = 0;
+    bool allMatch = true;
+    for (int processes = 1; processes <= maxProcesses; processes *= 2) {
+        Partitioning parts;
+        partitionRouters(initial, N, processes, parts);
+        vector<Node> nodes = initial;
+        auto start = chrono::steady_clock::now();
+        int rounds = runPartitioned(nodes, N, 1, processes, false, metrics);
+        double seconds = secondsSince(start);
+        if (rounds < 0) return 1;
+        if (reference.empty()) {
+            reference = nodes;
+            baseSeconds = seconds;
+        }
+        bool agrees = true;
+        for (int i = 1; i <= N && agrees; ++i) {
+            agrees = nodes[i].distanceVector == reference[i].distanceVector;
+        }
+        allMatch = allMatch && agrees;
+        printf("%9d %9d %6d %10.2f %10.1f %7.2fx %s\n", parts.parts, parts.cutEdges, rounds,
+               seconds * 1000 / rounds, seconds * 1000, baseSeconds / seconds,
+               agrees ? "match" : "DIFFER");
+    }
+    return allMatch ? 0 : 1;
+}
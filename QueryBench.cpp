@@ -0,0 +1,124 @@
+// Times routing-table output and queries on converged tables: the stream
+// dump printRoutingTables used to do against the bulk writer, then
+// lookup() and path() throughput.
+#include "metrics.hpp"
+#include "routes.hpp"
+#include "sweep.hpp"
+#include "topology.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <sstream>
+
+using namespace std;
+
+// The per-cell `<<` and map lookups of the original printRoutingTables
+static void streamRoutingTables(const vector<Node>& nodes, int N, ostream& out) {
+    for (int i = 1; i <= N; ++i) {
+        out << "Routing table for Node " << i << ":\n";
+        out << "Destination\tCost\tNext Hop\n";
+        for (int j = 1; j <= N; ++j) {
+            if (nodes[i].distanceVector.at(j) >= INFINITY) {
+                out << j << "\t\t" << "INF" << "\t" << "-\n";
+            } else {
+                out << j << "\t\t" << nodes[i].distanceVector.at(j) << "\t" << nodes[i].nextHop.at(j) << "\n";
+            }
+        }
+        out << "\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int N = argc > 1 ? atoi(argv[1]) : 1000;
+    int M = argc > 2 ? atoi(argv[2]) : 3 * N;
+    uint64_t seed = argc > 3 ? strtoull(argv[3], nullptr, 10) : 1;
+    int queries = argc > 4 ? atoi(argv[4]) : 2000000;
+    if (N < 2 || queries < 1) {
+        cerr << "Usage: " << argv[0] << " [routers] [links] [seed] [queries]\n";
+        return 1;
+    }
+
+    vector<Edge> edges = randomTopology(N, M, 20, seed);
+    vector<Node> nodes;
+    buildNodes(nodes, edges, N);
+    FlatTables tables;
+    tables.load(nodes, N);
+    MetricsRecorder metrics;
+    int rounds = runSweep(tables, nodes, 1, SWEEP_JACOBI, 1, 0, false, metrics);
+    tables.store(nodes);
+    cout << "Query comparison: " << N << " routers, " << edges.size() << " links, seed " << seed
+         << ", converged in " << rounds << " rounds\n";
+
+    // Output: both writers must produce the same text
+    ostringstream streamed;
+    streamRoutingTables(nodes, N, streamed);
+    OutputBuffer buffered;
+    FlatTables flat;
+    flat.load(nodes, N);
+    writeRoutingTables(flat, RouterRanges(), buffered);
+    bool sameText = streamed.str() == buffered.text();
+
+    int devNull = open("/dev/null", O_WRONLY);
+    if (devNull < 0) {
+        cerr << "Error opening /dev/null\n";
+        return 1;
+    }
+    ofstream nullStream("/dev/null");
+    auto start = chrono::steady_clock::now();
+    streamRoutingTables(nodes, N, nullStream);
+    nullStream.flush();
+    double streamSeconds = secondsSince(start);
+
+    start = chrono::steady_clock::now();
+    {
+        FlatTables dump;
+        dump.load(nodes, N);
+        OutputBuffer out(devNull);
+        writeRoutingTables(dump, RouterRanges(), out);
+    }
+    double bulkSeconds = secondsSince(start);
+    close(devNull);
+
+    double mb = buffered.text().size() / 1e6;
+    printf("%-22s %10s %10s\n", "output", "ms", "MB/s");
+    printf("%-22s %10.1f %10.1f\n", "stream (<<, map .at)", streamSeconds * 1000, mb / streamSeconds);
+    printf("%-22s %10.1f %10.1f\n", "bulk writer", bulkSeconds * 1000, mb / bulkSeconds);
+    printf("identical text: %s\n\n", sameText ? "yes" : "NO");
+
+    // Queries over random pairs
+    RouteTable table;
+    table.build(tables);
+    XorShift64 rng(seed);
+    vector<int> pairs(2 * size_t(queries));
+    for (int& id : pairs) id = 1 + rng.below(N);
+
+    long long checksum = 0;
+    start = chrono::steady_clock::now();
+    for (int q = 0; q < queries; ++q) {
+        Route route = table.lookup(pairs[2 * q], pairs[2 * q + 1]);
+        checksum += route.cost + route.nextHop;
+    }
+    double lookupSeconds = secondsSince(start);
+
+    vector<int> hops;
+    long long totalHops = 0;
+    int broken = 0;
+    start = chrono::steady_clock::now();
+    for (int q = 0; q < queries; ++q) {
+        if (table.path(pairs[2 * q], pairs[2 * q + 1], hops)) {
+            totalHops += hops.size() - 1;
+        } else {
+            broken++;
+        }
+    }
+    double pathSeconds = secondsSince(start);
+
+    printf("%-22s %10s %12s %10s\n", "query", "ms", "queries/s", "ns/query");
+    printf("%-22s %10.1f %12.0f %10.1f\n", "lookup(src, dst)", lookupSeconds * 1000,
+           queries / lookupSeconds, lookupSeconds * 1e9 / queries);
+    printf("%-22s %10.1f %12.0f %10.1f\n", "path(src, dst)", pathSeconds * 1000,
+           queries / pathSeconds, pathSeconds * 1e9 / queries);
+    printf("mean path length %.2f hops, %d unreachable or looping (checksum %lld)\n",
+           double(totalHops) / max(1, queries - broken), broken, checksum);
+    return 0;
+}
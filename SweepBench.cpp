@@ -0,0 +1,100 @@
+// Compares Jacobi and Gauss-Seidel sweeps on a random topology: rounds to
+// converge against time per round, for several thread counts and visit orders.
+#include "ecmp.hpp"
+#include "metrics.hpp"
+#include "sweep.hpp"
+#include "topology.hpp"
+#include <cstdio>
+#include <cstdlib>
+
+using namespace std;
+
+struct SweepRun {
+    string mode;
+    int threads;
+    string order;
+    int rounds;
+    double seconds;
+    bool agrees;
+};
+
+int main(int argc, char* argv[]) {
+    int N = argc > 1 ? atoi(argv[1]) : 400;
+    int M = argc > 2 ? atoi(argv[2]) : 3 * N;
+    uint64_t seed = argc > 3 ? strtoull(argv[3], nullptr, 10) : 1;
+    int maxThreads = argc > 4 ? atoi(argv[4]) : 8;
+    if (N < 2 || maxThreads < 1) {
+        cerr << "Usage: " << argv[0] << " [routers] [links] [seed] [max threads]\n";
+        return 1;
+    }
+
+    vector<Edge> edges = randomTopology(N, M, 20, seed);
+    vector<Node> nodes;
+    buildNodes(nodes, edges, N);
+    FlatTables initial;
+    initial.load(nodes, N);
+    MetricsRecorder metrics;
+
+    cout << "Sweep comparison: " << N << " routers, " << edges.size() << " links, seed " << seed << "\n";
+
+    vector<SweepRun> runs;
+    FlatTables reference;
+    auto run = [&](SweepMode mode, int threads, uint64_t orderSeed) {
+        FlatTables tables = initial;
+        auto start = chrono::steady_clock::now();
+        int rounds = runSweep(tables, nodes, 1, mode, threads, orderSeed, false, metrics);
+        double seconds = secondsSince(start);
+        if (reference.N == 0) reference = tables;
+        SweepRun result;
+        result.mode = mode == SWEEP_JACOBI ? "jacobi" : "gauss-seidel";
+        result.threads = threads;
+        result.order = mode == SWEEP_JACOBI ? "-" : orderSeed == 0 ? "ids" : "seed " + to_string(orderSeed);
+        result.rounds = rounds;
+        result.seconds = seconds;
+        result.agrees = tables.dist == reference.dist;
+        runs.push_back(result);
+    };
+
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        run(SWEEP_JACOBI, threads, 0);
+    }
+    run(SWEEP_GAUSS_SEIDEL, 1, 0);
+    for (uint64_t orderSeed = 1; orderSeed <= 3; ++orderSeed) {
+        run(SWEEP_GAUSS_SEIDEL, 1, orderSeed);
+    }
+
+    // Multipath engine on the same topology: K next hops, with and without
+    // the composite metric, against the single-next-hop Jacobi round
+    auto runMultipath = [&](int ways, bool composite) {
+        EcmpTables ecmp;
+        ecmp.maxWays = ways;
+        ecmp.composite = composite;
+        ecmp.load(initial);
+        auto start = chrono::steady_clock::now();
+        int rounds = runEcmp(ecmp, nodes, 1, false, metrics);
+        double seconds = secondsSince(start);
+        FlatTables tables = initial;
+        ecmp.store(tables);
+        SweepRun result;
+        result.mode = composite ? "ecmp+hops" : "ecmp";
+        result.threads = 1;
+        result.order = "k=" + to_string(ways);
+        result.rounds = rounds;
+        result.seconds = seconds;
+        result.agrees = tables.dist == reference.dist;
+        runs.push_back(result);
+    };
+    runMultipath(1, false);
+    runMultipath(MAX_ECMP_WAYS, false);
+    runMultipath(MAX_ECMP_WAYS, true);
+
+    printf("%-13s %7s %8s %6s %10s %10s %14s %s\n",
+           "mode", "threads", "order", "rounds", "ms/round", "total ms", "relaxations/s", "tables");
+    for (const SweepRun& r : runs) {
+        printf("%-13s %7d %8s %6d %10.2f %10.1f %14.0f %s\n",
+               r.mode.c_str(), r.threads, r.order.c_str(), r.rounds,
+               r.seconds * 1000 / r.rounds, r.seconds * 1000,
+               (double)r.rounds * N / r.seconds, r.agrees ? "match" : "DIFFER");
+    }
+    return 0;
+}
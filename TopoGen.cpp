@@ -0,0 +1,31 @@
+// Prints a random connected topology in the parts' input format: "N M", the
+// links, then the link to fail (a random link from the list).
+#include "topology.hpp"
+#include <cstdlib>
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        cerr << "Usage: " << argv[0] << " routers links [seed] [max cost]\n";
+        return 1;
+    }
+    int N = atoi(argv[1]);
+    int M = atoi(argv[2]);
+    uint64_t seed = argc > 3 ? strtoull(argv[3], nullptr, 10) : 1;
+    int maxCost = argc > 4 ? atoi(argv[4]) : 20;
+    if (N < 2 || maxCost < 1) {
+        cerr << "Need at least 2 routers and a positive max cost.\n";
+        return 1;
+    }
+
+    vector<Edge> edges = randomTopology(N, M, maxCost, seed);
+    cout << N << " " << edges.size() << "\n";
+    for (const Edge& edge : edges) {
+        cout << edge.src << " " << edge.dest << " " << edge.cost << "\n";
+    }
+    XorShift64 rng(seed ^ 0x5DEECE66Dull);
+    const Edge& failed = edges[rng.below(edges.size())];
+    cout << failed.src << " " << failed.dest << "\n";
+    return 0;
+}
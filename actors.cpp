@@ -0,0 +1,184 @@
+#include "actors.hpp"
+#include "engine.hpp"
+#include "metrics.hpp"
+#include <memory>
+
+using namespace std;
+
+// One router's row as advertised at some moment, shared by every neighbour
+// it was sent to and recycled when the last of them has moved on
+struct RowSnapshot {
+    int refs = 0;
+    vector<int> dist, next;
+};
+
+// An advertisement arriving on one entry of the receiver's neighbour list
+struct RowAdvert {
+    int link = 0;
+    RowSnapshot* row = nullptr;
+};
+
+struct ActorRouter {
+    vector<int> dist, next;             // Current row
+    vector<int> newDist, newNext;       // Scratch row for relaxRouter
+    vector<RowSnapshot*> latest;        // Newest row received per neighbour entry
+    size_t unheard = 0;                 // Neighbour entries with nothing received yet
+    vector<const int*> nbrDist, nbrNext;
+    vector<pair<int, int>> outLinks;    // (receiver, receiver's neighbour entry) per neighbour entry
+    ActorInbox<RowAdvert> inbox;
+};
+
+// State shared by the actors of one run
+struct ActorRun {
+    int N = 0;
+    int method = 1;
+    bool stopOnCountToInfinity = false;
+    bool stopped = false;
+    long long messages = 0;
+    Executor executor;
+    vector<ActorRouter> routers;
+    vector<unique_ptr<RowSnapshot>> rows;
+    vector<RowSnapshot*> freeRows;
+    RowSnapshot unknown;                // Stands for a neighbour that has not advertised yet
+
+    // Replaces the row held for one neighbour entry
+    void receive(ActorRouter& self, const RowAdvert& advert) {
+        RowSnapshot*& held = self.latest[advert.link];
+        if (held == &unknown) {
+            self.unheard--;
+        } else if (--held->refs == 0) {
+            freeRows.push_back(held);
+        }
+        held = advert.row;
+    }
+
+    // Sends router r's current row to every neighbour
+    void advertise(int r) {
+        ActorRouter& self = routers[r];
+        if (self.outLinks.empty()) return;
+        RowSnapshot* row;
+        if (freeRows.empty()) {
+            rows.emplace_back(new RowSnapshot());
+            row = rows.back().get();
+        } else {
+            row = freeRows.back();
+            freeRows.pop_back();
+        }
+        row->dist = self.dist;
+        row->next = self.next;
+        row->refs = self.outLinks.size();
+        for (auto& link : self.outLinks) {
+            routers[link.first].inbox.send(RowAdvert{link.second, row}, executor);
+        }
+        messages += self.outLinks.size();
+    }
+
+    // Recomputes router r's row from the newest rows received, again while
+    // its own costs keep changing (relaxRouter reads the cost to each
+    // neighbour from the row itself). Returns true if costs or next hops changed.
+    bool relax(int r, const vector<int>& neighbors) {
+        ActorRouter& self = routers[r];
+        for (size_t k = 0; k < neighbors.size(); ++k) {
+            self.nbrDist[k] = self.latest[k]->dist.data();
+            self.nbrNext[k] = self.latest[k]->next.data();
+        }
+        bool rowChanged = false;
+        bool costChanged;
+        do {
+            costChanged = relaxRouter(r, N, method, neighbors, self.dist.data(), self.next.data(),
+                                      self.nbrDist.data(), self.nbrNext.data(),
+                                      self.newDist.data(), self.newNext.data());
+            if (costChanged || self.newNext != self.next) rowChanged = true;
+            self.dist.swap(self.newDist);
+            self.next.swap(self.newNext);
+        } while (costChanged);
+        if (!rowChanged) return false;
+        if (stopOnCountToInfinity) {
+            for (int j = 1; j <= N; ++j) {
+                if (self.dist[j] > COUNT_TO_INFINITY_LIMIT && self.dist[j] < INFINITY) stopped = true;
+            }
+        }
+        return true;
+    }
+};
+
+// The life of one router. It does not relax before every neighbour has
+// advertised once: with a neighbour's row missing, relaxRouter would replace
+// the cost to that neighbour by a detour, and it never reads link costs again.
+static Actor routerActor(ActorRun& run, int r, const vector<int>& neighbors) {
+    ActorRouter& self = run.routers[r];
+    run.advertise(r);
+    while (!run.stopped) {
+        RowAdvert advert = co_await self.inbox.receive();
+        // Take everything that has arrived; only the newest row per link matters
+        do {
+            run.receive(self, advert);
+        } while (self.inbox.tryReceive(advert));
+        if (run.stopped) break;
+        if (self.unheard == 0 && run.relax(r, neighbors)) run.advertise(r);
+    }
+}
+
+int runActors(vector<Node>& nodes, int N, int method, bool stopOnCountToInfinity,
+              MetricsRecorder& metrics) {
+    size_t row = N + 1;
+    ActorRun run;
+    run.N = N;
+    run.method = method;
+    run.stopOnCountToInfinity = stopOnCountToInfinity;
+    run.unknown.dist.assign(row, INFINITY);
+    run.unknown.next.assign(row, -1);
+    FlatTables tables;
+    tables.load(nodes, N);
+    run.routers.resize(N + 1);
+    for (int r = 1; r <= N; ++r) {
+        ActorRouter& self = run.routers[r];
+        self.dist.assign(tables.distRow(r), tables.distRow(r) + row);
+        self.next.assign(tables.nextRow(r), tables.nextRow(r) + row);
+        self.newDist.resize(row);
+        self.newNext.resize(row);
+        size_t degree = nodes[r].neighbors.size();
+        self.latest.assign(degree, &run.unknown);
+        self.unheard = degree;
+        self.nbrDist.resize(degree);
+        self.nbrNext.resize(degree);
+    }
+
+    // Send each neighbour entry of u to the matching entry of v
+    vector<vector<int>> peer = pairNeighborEntries(nodes, N);
+    for (int u = 1; u <= N; ++u) {
+        for (size_t k = 0; k < peer[u].size(); ++k) {
+            run.routers[u].outLinks.push_back({nodes[u].neighbors[k], peer[u][k]});
+        }
+    }
+
+    vector<Actor> actors;
+    actors.reserve(N);
+    for (int r = 1; r <= N; ++r) {
+        actors.push_back(routerActor(run, r, nodes[r].neighbors));
+        run.executor.schedule(actors.back().start());
+    }
+
+    vector<const int*> distRows(row), nextRows(row);
+    int waves = 0;
+    while (true) {
+        auto start = chrono::steady_clock::now();
+        long long sent = run.messages;
+        if (run.executor.runWave() == 0) break;
+        ++waves;
+        if (metrics.enabled()) {
+            for (int r = 1; r <= N; ++r) {
+                distRows[r] = run.routers[r].dist.data();
+                nextRows[r] = run.routers[r].next.data();
+            }
+            metrics.recordRows(distRows, nextRows, N, run.messages - sent, secondsSince(start));
+        }
+    }
+
+    for (int r = 1; r <= N; ++r) {
+        copy(run.routers[r].dist.begin(), run.routers[r].dist.end(), tables.distRow(r));
+        copy(run.routers[r].next.begin(), run.routers[r].next.end(), tables.nextRow(r));
+    }
+    tables.store(nodes);
+    return waves;
+}
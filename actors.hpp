@@ -0,0 +1,130 @@
+#ifndef ACTORS_HPP
+#define ACTORS_HPP
+#include "defs.hpp"
+#include <coroutine>
+#include <exception>
+#include <new>
+
+class MetricsRecorder;
+
+// Coroutine of one actor. It is created suspended and started by the
+// executor; destroying the Actor destroys the frame wherever it is suspended.
+class Actor {
+public:
+    struct promise_type {
+        Actor get_return_object() {
+            return Actor(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+
+        // Frames are counted so the per-actor cost can be reported
+        static void* operator new(size_t bytes) {
+            frameBytes += bytes;
+            return ::operator new(bytes);
+        }
+        static void operator delete(void* frame, size_t bytes) {
+            frameBytes -= bytes;
+            ::operator delete(frame);
+        }
+        static inline size_t frameBytes = 0;   // Bytes held by live actor frames
+    };
+
+    Actor() = default;
+    explicit Actor(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+    Actor(Actor&& other) noexcept : handle(other.handle) { other.handle = nullptr; }
+    Actor& operator=(Actor&& other) noexcept {
+        std::swap(handle, other.handle);
+        return *this;
+    }
+    Actor(const Actor&) = delete;
+    Actor& operator=(const Actor&) = delete;
+    ~Actor() {
+        if (handle) handle.destroy();
+    }
+
+    std::coroutine_handle<> start() const { return handle; }
+    bool done() const { return handle.done(); }
+
+private:
+    std::coroutine_handle<promise_type> handle;
+};
+
+// Single-threaded run queue. Coroutines made ready during a wave run in the
+// next one, in the order they were woken, so a run replays exactly.
+class Executor {
+public:
+    void schedule(std::coroutine_handle<> handle) { ready.push_back(handle); }
+
+    // Resumes everything that was ready at the start of the wave. Returns the
+    // number of resumptions; 0 means every actor is suspended or finished.
+    size_t runWave() {
+        running.swap(ready);
+        for (std::coroutine_handle<> handle : running) handle.resume();
+        size_t resumed = running.size();
+        running.clear();
+        return resumed;
+    }
+
+private:
+    std::vector<std::coroutine_handle<>> ready, running;
+};
+
+// Mailbox of one actor: a FIFO of messages and the actor waiting on it.
+// `co_await inbox.receive()` returns the next message, suspending while the
+// inbox is empty. Only the executor's thread may touch it.
+template <typename Message>
+class ActorInbox {
+public:
+    // Queues a message and wakes the owner if it is suspended in receive()
+    void send(const Message& message, Executor& executor) {
+        queue.push_back(message);
+        if (waiter) {
+            executor.schedule(waiter);
+            waiter = nullptr;
+        }
+    }
+
+    // Takes a message without suspending; returns false if there is none
+    bool tryReceive(Message& message) {
+        if (head == queue.size()) return false;
+        message = queue[head++];
+        if (head == queue.size()) {
+            queue.clear();
+            head = 0;
+        }
+        return true;
+    }
+
+    auto receive() {
+        struct Awaiter {
+            ActorInbox* inbox;
+            bool await_ready() const { return inbox->head < inbox->queue.size(); }
+            void await_suspend(std::coroutine_handle<> handle) { inbox->waiter = handle; }
+            Message await_resume() {
+                Message message;
+                inbox->tryReceive(message);
+                return message;
+            }
+        };
+        return Awaiter{this};
+    }
+
+private:
+    std::vector<Message> queue;
+    size_t head = 0;
+    std::coroutine_handle<> waiter;
+};
+
+// Runs DVR with one coroutine actor per router on a single-threaded executor.
+// Each actor advertises its row, then loops: receive the neighbours'
+// advertisements, relax, and advertise again if its row changed. There are no
+// global rounds; the run ends when every actor is suspended on an empty inbox,
+// or, if stopOnCountToInfinity is set, when some cost passes the limit.
+// Metrics are recorded per executor wave. Returns the number of waves.
+int runActors(std::vector<Node>& nodes, int N, int method, bool stopOnCountToInfinity,
+              MetricsRecorder& metrics);
+
+#endif // ACTORS_HPP
@@ -0,0 +1,33 @@
+#ifndef BARRIER_HPP
+#define BARRIER_HPP
+#include <atomic>
+#include <thread>
+
+// Reusable barrier that spins (yielding) instead of sleeping on a lock
+class SpinBarrier {
+public:
+    explicit SpinBarrier(int count) : count(count) {}
+
+    // Returns how many times this thread yielded waiting for the others
+    long long wait() {
+        long long yields = 0;
+        unsigned gen = generation.load(std::memory_order_acquire);
+        if (arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == count) {
+            arrived.store(0, std::memory_order_relaxed);
+            generation.fetch_add(1, std::memory_order_release);
+        } else {
+            while (generation.load(std::memory_order_acquire) == gen) {
+                std::this_thread::yield();
+                yields++;
+            }
+        }
+        return yields;
+    }
+
+private:
+    const int count;
+    alignas(64) std::atomic<int> arrived{0};
+    alignas(64) std::atomic<unsigned> generation{0};
+};
+
+#endif // BARRIER_HPP
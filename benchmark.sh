@@ -0,0 +1,98 @@
+#!/bin/sh
+# Runs the benchmark suite against one or more build directories (each holding
+# Part1, Part2 and Part3). For every build it prints the best time over
+# REPEATS runs of the suite, the speedup over the first build, and whether the
+# output matches the first build's.
+#
+#   ./benchmark.sh [-n REPEATS] [--train] TOPOLOGY_DIR BUILD_DIR...
+#
+# --train runs the suite once per build and prints nothing (PGO training).
+
+repeats=3
+train=0
+while [ $# -gt 0 ]; do
+    case "$1" in
+        -n) repeats=$2; shift 2 ;;
+        --train) train=1; shift ;;
+        *) break ;;
+    esac
+done
+if [ $# -lt 2 ]; then
+    echo "Usage: $0 [-n REPEATS] [--train] TOPOLOGY_DIR BUILD_DIR..." >&2
+    exit 1
+fi
+topologies=$(cd "$1" && pwd) || exit 1
+shift
+
+# The parts write their iteration files under the working directory
+work=$(mktemp -d) || exit 1
+trap 'rm -rf "$work"' EXIT
+
+# Part3's own loop is left out: its split horizon can count to infinity
+# without ever reaching the detection threshold
+CASES="Part1|Part2|Part3 --sweep gauss-seidel|Part1 --sweep jacobi|Part2 --ecmp 4"
+
+# Runs every case on every topology with the binaries in $1, appending stdout
+# to $2. Returns non-zero if any run failed.
+runSuite() {
+    bin=$1
+    out=$2
+    status=0
+    for topology in "$topologies"/*.txt; do
+        oldIFS=$IFS
+        IFS='|'
+        for case in $CASES; do
+            IFS=$oldIFS
+            set -- $case
+            program=$1
+            shift
+            if ! (cd "$work" && "$bin/$program" "$@" < "$topology") >> "$out" 2>> "$work/stderr"; then
+                echo "$bin/$program $* < $topology failed" >&2
+                status=1
+            fi
+            IFS='|'
+        done
+        IFS=$oldIFS
+    done
+    return $status
+}
+
+if [ $train -eq 1 ]; then
+    for build in "$@"; do
+        runSuite "$(cd "$build" && pwd)" /dev/null || exit 1
+    done
+    exit 0
+fi
+
+printf "%-16s %10s %8s %s\n" "build" "best s" "speedup" "output"
+first=""
+reference=""
+for build in "$@"; do
+    bin=$(cd "$build" && pwd) || exit 1
+    best=""
+    failed=0
+    run=0
+    while [ $run -lt "$repeats" ]; do
+        rm -f "$work/out"
+        start=$(date +%s%N)
+        runSuite "$bin" "$work/out" || failed=1
+        end=$(date +%s%N)
+        elapsed=$((end - start))
+        if [ -z "$best" ] || [ $elapsed -lt "$best" ]; then best=$elapsed; fi
+        run=$((run + 1))
+    done
+    sum=$(cksum < "$work/out")
+    if [ -z "$reference" ]; then
+        reference=$sum
+        first=$best
+    fi
+    if [ $failed -eq 1 ]; then
+        verdict="FAILED"
+    elif [ "$sum" = "$reference" ]; then
+        verdict="same"
+    else
+        verdict="DIFFERS"
+    fi
+    awk -v name="$build" -v ns="$best" -v base="$first" -v verdict="$verdict" \
+        'BEGIN { printf "%-16s %10.3f %7.2fx %s\n", name, ns / 1e9, base / ns, verdict }'
+done
@@ -0,0 +1,209 @@
+#include "checkpoint.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+
+using namespace std;
+
+static_assert(sizeof(CheckpointHeader) == 48, "checkpoint header layout changed");
+static_assert(sizeof(Edge) == 3 * sizeof(int32_t), "checkpoint stores Edge as three int32");
+
+static const char CHECKPOINT_MAGIC[8] = "DVRCKPT";
+
+static size_t align8(size_t bytes) {
+    return (bytes + 7) & ~size_t(7);
+}
+
+// Four independent multiply-xor lanes over 8-byte words, so hashing keeps up
+// with reading the mapping. `size` must be a multiple of 8.
+static uint64_t checksumWords(const unsigned char* data, size_t size, uint64_t seed) {
+    const uint64_t prime = 0x9E3779B97F4A7C15ull;
+    uint64_t lane[4] = {seed, seed ^ 1, seed ^ 2, seed ^ 3};
+    size_t words = size / 8;
+    size_t i = 0;
+    for (; i + 4 <= words; i += 4) {
+        for (int k = 0; k < 4; ++k) {
+            uint64_t w;
+            memcpy(&w, data + (i + k) * 8, 8);
+            lane[k] = (lane[k] ^ w) * prime;
+            lane[k] ^= lane[k] >> 31;
+        }
+    }
+    for (; i < words; ++i) {
+        uint64_t w;
+        memcpy(&w, data + i * 8, 8);
+        lane[0] = (lane[0] ^ w) * prime;
+        lane[0] ^= lane[0] >> 31;
+    }
+    uint64_t h = size;
+    for (int k = 0; k < 4; ++k) {
+        h = (h ^ lane[k]) * prime;
+        h ^= h >> 29;
+    }
+    return h;
+}
+
+static uint64_t checkpointChecksum(const CheckpointHeader& header, const unsigned char* payload) {
+    CheckpointHeader copy = header;
+    copy.checksum = 0;
+    uint64_t h = checksumWords(reinterpret_cast<const unsigned char*>(&copy), sizeof(copy), 0);
+    return checksumWords(payload, header.payloadBytes, h);
+}
+
+static void payloadLayout(int N, int M, size_t& edgeBytes, size_t& tableBytes) {
+    size_t row = N + 1;
+    edgeBytes = align8(size_t(M) * sizeof(Edge));
+    tableBytes = align8(row * row * sizeof(int32_t));
+}
+
+bool saveCheckpoint(const string& path, const vector<Node>& nodes,
+                    const vector<Edge>& edges, int N, int method) {
+    size_t row = N + 1;
+    size_t edgeBytes, tableBytes;
+    payloadLayout(N, edges.size(), edgeBytes, tableBytes);
+
+    vector<unsigned char> payload(edgeBytes + 2 * tableBytes, 0);
+    memcpy(payload.data(), edges.data(), edges.size() * sizeof(Edge));
+    int32_t* dist = reinterpret_cast<int32_t*>(payload.data() + edgeBytes);
+    int32_t* next = reinterpret_cast<int32_t*>(payload.data() + edgeBytes + tableBytes);
+    for (size_t k = 0; k < row * row; ++k) {
+        dist[k] = INFINITY;
+        next[k] = -1;
+    }
+    for (int i = 1; i <= N; ++i) {
+        for (auto& entry : nodes[i].distanceVector) dist[i * row + entry.first] = entry.second;
+        for (auto& entry : nodes[i].nextHop) next[i * row + entry.first] = entry.second;
+    }
+
+    CheckpointHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic));
+    header.version = CHECKPOINT_VERSION;
+    header.headerSize = sizeof(header);
+    header.N = N;
+    header.M = edges.size();
+    header.method = method;
+    header.payloadBytes = payload.size();
+    header.checksum = checkpointChecksum(header, payload.data());
+
+    string tmpPath = path + ".tmp";
+    ofstream outFile(tmpPath, ios::binary);
+    if (!outFile.is_open()) {
+        cerr << "Error opening file " << tmpPath << "\n";
+        return false;
+    }
+    outFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    outFile.write(reinterpret_cast<const char*>(payload.data()), payload.size());
+    outFile.close();
+    if (!outFile || rename(tmpPath.c_str(), path.c_str()) != 0) {
+        cerr << "Error writing checkpoint " << path << "\n";
+        remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool mapCheckpoint(const string& path, CheckpointView& view) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        cerr << "Error opening checkpoint " << path << "\n";
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || size_t(info.st_size) < sizeof(CheckpointHeader)) {
+        cerr << "Checkpoint " << path << " is truncated\n";
+        close(fd);
+        return false;
+    }
+    size_t bytes = info.st_size;
+    void* base = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        cerr << "Error mapping checkpoint " << path << "\n";
+        return false;
+    }
+    view.base = base;
+    view.bytes = bytes;
+
+    const CheckpointHeader* header = static_cast<const CheckpointHeader*>(base);
+    const char* reason = nullptr;
+    size_t edgeBytes = 0, tableBytes = 0;
+    if (memcmp(header->magic, CHECKPOINT_MAGIC, sizeof(header->magic)) != 0) {
+        reason = "is not a checkpoint";
+    } else if (header->version != CHECKPOINT_VERSION || header->headerSize != sizeof(CheckpointHeader)) {
+        reason = "was written by an unsupported version";
+    } else if (header->N < 1 || header->M < 0) {
+        reason = "has an invalid header";
+    } else {
+        payloadLayout(header->N, header->M, edgeBytes, tableBytes);
+        if (header->payloadBytes != edgeBytes + 2 * tableBytes ||
+            bytes != sizeof(CheckpointHeader) + header->payloadBytes) {
+            reason = "is truncated";
+        }
+    }
+    const unsigned char* payload = static_cast<const unsigned char*>(base) + sizeof(CheckpointHeader);
+    if (reason == nullptr && checkpointChecksum(*header, payload) != header->checksum) {
+        reason = "failed its checksum";
+    }
+    if (reason != nullptr) {
+        cerr << "Checkpoint " << path << " " << reason << "\n";
+        unmapCheckpoint(view);
+        return false;
+    }
+
+    view.header = header;
+    view.edges = reinterpret_cast<const Edge*>(payload);
+    view.dist = reinterpret_cast<const int32_t*>(payload + edgeBytes);
+    view.next = reinterpret_cast<const int32_t*>(payload + edgeBytes + tableBytes);
+    return true;
+}
+
+void unmapCheckpoint(CheckpointView& view) {
+    if (view.base != nullptr) {
+        munmap(view.base, view.bytes);
+    }
+    view = CheckpointView();
+}
+
+bool loadCheckpoint(const string& path, int method, vector<Node>& nodes,
+                    vector<Edge>& edges, int& N) {
+    CheckpointView view;
+    if (!mapCheckpoint(path, view)) {
+        return false;
+    }
+    if (view.header->method != method) {
+        cerr << "Checkpoint " << path << " was converged with method " << view.header->method
+             << ", not " << method << "\n";
+        unmapCheckpoint(view);
+        return false;
+    }
+
+    N = view.header->N;
+    size_t row = N + 1;
+    edges.assign(view.edges, view.edges + view.header->M);
+    nodes.assign(N + 1, Node());
+    for (int i = 1; i <= N; ++i) {
+        nodes[i].id = i;
+    }
+    for (auto& edge : edges) {
+        if (edge.src < 1 || edge.src > N || edge.dest < 1 || edge.dest > N) {
+            cerr << "Checkpoint " << path << " has a link to an unknown router\n";
+            unmapCheckpoint(view);
+            return false;
+        }
+        nodes[edge.src].neighbors.push_back(edge.dest);
+        nodes[edge.dest].neighbors.push_back(edge.src);
+    }
+    // Rows are sorted by destination, so every insert lands at the end of the map
+    for (int i = 1; i <= N; ++i) {
+        const int32_t* dist = view.dist + i * row;
+        const int32_t* next = view.next + i * row;
+        for (int j = 1; j <= N; ++j) {
+            nodes[i].distanceVector.emplace_hint(nodes[i].distanceVector.end(), j, dist[j]);
+            nodes[i].nextHop.emplace_hint(nodes[i].nextHop.end(), j, next[j]);
+        }
+    }
+    unmapCheckpoint(view);
+    return true;
+}
@@ -0,0 +1,51 @@
+#ifndef CHECKPOINT_HPP
+#define CHECKPOINT_HPP
+#include "defs.hpp"
+#include <cstdint>
+
+// Version 1 checkpoint layout (host byte order, every section 8-byte aligned):
+//   CheckpointHeader
+//   Edge    edges[M]             (src, dest, cost)
+//   int32   dist[(N + 1) * (N + 1)]
+//   int32   next[(N + 1) * (N + 1)]
+// The checksum covers the header (with the checksum field zeroed) and the payload.
+const uint32_t CHECKPOINT_VERSION = 1;
+
+struct CheckpointHeader {
+    char magic[8];              // "DVRCKPT"
+    uint32_t version;
+    uint32_t headerSize;
+    int32_t N;                  // Routers
+    int32_t M;                  // Links
+    int32_t method;             // Policy the tables were converged under
+    uint32_t reserved;
+    uint64_t payloadBytes;
+    uint64_t checksum;
+};
+
+// Read-only view of a mapped checkpoint; the pointers stay valid until unmapCheckpoint
+struct CheckpointView {
+    const CheckpointHeader* header = nullptr;
+    const Edge* edges = nullptr;
+    const int32_t* dist = nullptr;   // Row-major, router i at i * (N + 1)
+    const int32_t* next = nullptr;
+    void* base = nullptr;
+    size_t bytes = 0;
+};
+
+// Writes the converged tables, topology and policy to `path` (via a temporary
+// file that is renamed into place). Returns false on I/O errors.
+bool saveCheckpoint(const std::string& path, const std::vector<Node>& nodes,
+                    const std::vector<Edge>& edges, int N, int method);
+
+// Maps `path` and validates magic, version, sizes and checksum.
+// Prints the reason and returns false if the file is stale or corrupt.
+bool mapCheckpoint(const std::string& path, CheckpointView& view);
+void unmapCheckpoint(CheckpointView& view);
+
+// Restores nodes, edges and N from a checkpoint converged under `method`.
+// Rebuilding the map tables dominates: about 40x the time of mapCheckpoint.
+bool loadCheckpoint(const std::string& path, int method, std::vector<Node>& nodes,
+                    std::vector<Edge>& edges, int& N);
+
+#endif // CHECKPOINT_HPP
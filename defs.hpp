@@ -7,6 +7,7 @@
 #include <sys/stat.h>
 #include <vector>
 #include <map>
+#include <functional>
 #ifdef _WIN32
 #include <direct.h>  // For Windows mkdir
 #else
@@ -29,13 +30,24 @@ struct Node {
     std::vector<int> neighbors;                   // Neighboring nodes
 };
 
+// Routers to print, as inclusive id ranges in list order; empty = all routers
+typedef std::vector<std::pair<int, int>> RouterRanges;
+
+// One router's routing table as flat rows indexed by destination (0..N)
+typedef std::function<void(int router, const int* dist, const int* next)> RowVisitor;
+// Visits the rows of routers 1..N in id order; returns false on error
+typedef std::function<bool(const RowVisitor& visit)> RowSource;
+
 // Function prototypes
 void initializeNodes(std::vector<Node>& nodes, const std::vector<Edge>& edges, int N);
 void initializeDistanceVectors(std::vector<Node>& nodes, const std::vector<Edge>& edges, int N);
 bool updateDistanceVectors(std::vector<Node>& nodes, int N, int method);
-void printRoutingTables(const std::vector<Node>& nodes, int N);
+void printRoutingTables(const std::vector<Node>& nodes, int N, const RouterRanges& routers);
+void printRoutingTables(const RowSource& tables, int N, const RouterRanges& routers);
 bool checkCountToInfinity(const std::vector<Node>& nodes, int N);
+bool checkCountToInfinity(const RowSource& tables, int N);
 void createDirectoryIfNotExists(const std::string& dirName);
 void printDistanceVectorsToFile(const std::vector<Node>& nodes, int N, const std::string& filename);
+void printDistanceVectorsToFile(const RowSource& tables, int N, const std::string& filename);
 
 #endif // DEFS_HPP
@@ -0,0 +1,172 @@
+#include "ecmp.hpp"
+#include "metrics.hpp"
+#include "routes.hpp"
+#include <unistd.h>
+
+using namespace std;
+
+void EcmpTables::load(const FlatTables& tables) {
+    N = tables.N;
+    entries.assign((N + 1) * size_t(N + 1), EcmpEntry());
+    for (int i = 1; i <= N; ++i) {
+        EcmpEntry* out = row(i);
+        for (int j = 1; j <= N; ++j) {
+            EcmpEntry& entry = out[j];
+            entry.cost = tables.distRow(i)[j];
+            entry.ways = 0;
+            entry.hops = INFINITY;
+            if (entry.cost >= INFINITY) continue;
+            entry.nextHops[0] = tables.nextRow(i)[j];
+            entry.ways = 1;
+
+            // Hop count along the next-hop chain; a chain that loops keeps INFINITY
+            int hops = 0;
+            for (int u = i; u != j && hops <= N; ++hops) {
+                u = tables.nextRow(u)[j];
+                if (u < 1) {
+                    hops = N + 1;
+                    break;
+                }
+            }
+            if (hops <= N) entry.hops = hops;
+        }
+    }
+}
+
+void EcmpTables::store(FlatTables& tables) const {
+    for (int i = 1; i <= N; ++i) {
+        const EcmpEntry* in = row(i);
+        for (int j = 1; j <= N; ++j) {
+            tables.distRow(i)[j] = in[j].cost;
+            if (in[j].ways > 0) tables.nextRow(i)[j] = in[j].nextHops[0];
+        }
+    }
+}
+
+static bool contains(const EcmpEntry& entry, int router) {
+    for (int k = 0; k < entry.ways; ++k) {
+        if (entry.nextHops[k] == router) return true;
+    }
+    return false;
+}
+
+// Recomputes router r's row from the previous round into `out`; returns true if a cost changed
+static bool relaxEcmp(const EcmpTables& tables, const vector<Node>& nodes, int r, int method,
+                      EcmpEntry* out) {
+    int N = tables.N;
+    const EcmpEntry* self = tables.row(r);
+    copy(self, self + N + 1, out);
+    bool changed = false;
+
+    for (int j = 1; j <= N; ++j) {
+        if (j == r) continue;
+        EcmpEntry best;
+        best.cost = INFINITY;
+        best.hops = INFINITY;
+        best.ways = 0;
+        for (int u : nodes[r].neighbors) {
+            const EcmpEntry& adv = tables.row(u)[j];
+            if (method != 1 && contains(adv, r)) {
+                // Withheld (Split Horizon) or advertised as INFINITY (Poisoned
+                // Reverse): either way no candidate
+                continue;
+            }
+            int cost = self[u].cost + adv.cost;
+            int hops = self[u].hops + adv.hops;
+            if (cost >= INFINITY) continue;
+            bool better = cost < best.cost || (tables.composite && cost == best.cost && hops < best.hops);
+            bool equal = cost == best.cost && (!tables.composite || hops == best.hops);
+            if (better) {
+                best.cost = cost;
+                best.hops = hops;
+                best.ways = 1;
+                best.nextHops[0] = u;
+            } else if (equal && best.ways < tables.maxWays && !contains(best, u)) {
+                best.nextHops[best.ways++] = u;
+            }
+        }
+        // Entries with no finite candidate keep their previous value
+        if (best.ways > 0) {
+            best.hops = min(best.hops, int(INFINITY));
+            out[j] = best;
+        }
+        if (out[j].cost != self[j].cost) changed = true;
+    }
+    return changed;
+}
+
+int runEcmp(EcmpTables& tables, const vector<Node>& nodes, int method,
+            bool stopOnCountToInfinity, MetricsRecorder& metrics) {
+    int N = tables.N;
+    size_t row = N + 1;
+    EcmpTables nextTables = tables;
+    long long messages = advertisementsPerRound(nodes, N);
+    FlatTables flat;
+    flat.N = N;
+
+    for (int round = 1; ; ++round) {
+        auto start = chrono::steady_clock::now();
+        bool changed = false;
+        bool overLimit = false;
+        for (int r = 1; r <= N; ++r) {
+            changed |= relaxEcmp(tables, nodes, r, method, nextTables.row(r));
+            const EcmpEntry* out = nextTables.row(r);
+            for (int j = 1; j <= N; ++j) {
+                if (out[j].cost > COUNT_TO_INFINITY_LIMIT && out[j].cost < INFINITY) overLimit = true;
+            }
+        }
+        swap(tables.entries, nextTables.entries);
+
+        if (metrics.enabled()) {
+            flat.dist.assign(row * row, INFINITY);
+            flat.next.assign(row * row, -1);
+            tables.store(flat);
+            vector<const int*> dist(row), next(row);
+            for (int i = 1; i <= N; ++i) {
+                dist[i] = flat.distRow(i);
+                next[i] = flat.nextRow(i);
+            }
+            metrics.recordRows(dist, next, N, messages, secondsSince(start));
+        }
+        if (!changed || (stopOnCountToInfinity && overLimit)) return round;
+    }
+}
+
+void printEcmpRoutes(const EcmpTables& tables) {
+    // On stderr, so stdout keeps the same tables and prompts as the other engines
+    cout.flush();
+    OutputBuffer out(STDERR_FILENO);
+    out.put("\nEqual-cost next hops (up to ");
+    out.putInt(tables.maxWays);
+    out.put(tables.composite ? " per destination, composite cost/hops metric):\n"
+                             : " per destination):\n");
+    int multipath = 0;
+    for (int i = 1; i <= tables.N; ++i) {
+        const EcmpEntry* entries = tables.row(i);
+        for (int j = 1; j <= tables.N; ++j) {
+            const EcmpEntry& entry = entries[j];
+            if (entry.ways < 2 || entry.cost >= INFINITY) continue;
+            out.put("Node ");
+            out.putInt(i);
+            out.put(" -> ");
+            out.putInt(j);
+            out.put(": cost ");
+            out.putInt(entry.cost);
+            if (tables.composite) {
+                out.put(", ");
+                out.putInt(entry.hops);
+                out.put(" hops");
+            }
+            out.put(" via");
+            for (int k = 0; k < entry.ways; ++k) {
+                out.put(k ? ", " : " ");
+                out.putInt(entry.nextHops[k]);
+            }
+            out.put("\n");
+            multipath++;
+        }
+    }
+    if (multipath == 0) {
+        out.put("None\n");
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef ECMP_HPP
+#define ECMP_HPP
+#include "engine.hpp"
+
+class MetricsRecorder;
+
+// Most equal-cost next hops an entry can hold
+const int MAX_ECMP_WAYS = 4;
+
+// One routing entry with its equal-cost next hops stored inline, so the tables
+// are a single flat array with no per-entry allocation
+struct EcmpEntry {
+    int cost;                       // Primary metric: summed link cost (latency)
+    int hops;                       // Secondary metric for the composite comparison
+    int ways;                       // Valid entries in nextHops
+    int nextHops[MAX_ECMP_WAYS];    // In neighbour order; nextHops[0] is the primary next hop
+};
+
+struct EcmpTables {
+    int N = 0;
+    int maxWays = 1;                // Equal-cost next hops kept per entry (1..MAX_ECMP_WAYS)
+    bool composite = false;         // Compare (cost, hops) lexicographically instead of cost
+    std::vector<EcmpEntry> entries; // (N + 1) x (N + 1), row-major by router
+
+    EcmpEntry* row(int i) { return &entries[i * size_t(N + 1)]; }
+    const EcmpEntry* row(int i) const { return &entries[i * size_t(N + 1)]; }
+
+    // Copies costs and next hops in (hop counts follow the next-hop chains)
+    // and the costs and primary next hops back out
+    void load(const FlatTables& tables);
+    void store(FlatTables& tables) const;
+};
+
+// Runs Jacobi rounds that keep up to tables.maxWays equal-best next hops per
+// destination. Under Poisoned Reverse / Split Horizon a neighbour withholds a
+// route from every router in that route's next-hop set. Stops like the other
+// engines. Returns the number of rounds.
+int runEcmp(EcmpTables& tables, const std::vector<Node>& nodes, int method,
+            bool stopOnCountToInfinity, MetricsRecorder& metrics);
+
+// Prints the entries that have more than one next hop, on stderr
+void printEcmpRoutes(const EcmpTables& tables);
+
+#endif // ECMP_HPP
@@ -0,0 +1,144 @@
+#include "engine.hpp"
+#include "actors.hpp"
+#include "ecmp.hpp"
+#include "options.hpp"
+#include "partition.hpp"
+#include "sweep.hpp"
+#include "threaded.hpp"
+#include "wire.hpp"
+#include <cstring>
+
+using namespace std;
+
+bool relaxRouter(int self, int N, int method, const vector<int>& neighbors,
+                 const int* selfDist, const int* selfNext,
+                 const int* const* nbrDist, const int* const* nbrNext,
+                 int* outDist, int* outNext) {
+    // Entries with no finite candidate keep their previous value
+    memcpy(outDist, selfDist, (N + 1) * sizeof(int));
+    memcpy(outNext, selfNext, (N + 1) * sizeof(int));
+
+    bool changed = false;
+    for (int j = 1; j <= N; ++j) {
+        if (j == self) continue; // Skip its own entry
+
+        int minCost = INFINITY;
+        for (size_t k = 0; k < neighbors.size(); ++k) {
+            int neighbor = neighbors[k];
+            int adv = advertisedCost(self, j, nbrDist[k][j], nbrNext[k][j], method);
+            if (adv < 0) continue;
+            int cost = selfDist[neighbor] + adv;
+            if (cost < minCost) {
+                minCost = cost;
+                outDist[j] = cost;
+                outNext[j] = neighbor;
+            }
+        }
+        if (outDist[j] != selfDist[j]) {
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+void FlatTables::load(const vector<Node>& nodes, int routers) {
+    N = routers;
+    dist.assign(row() * row(), INFINITY);
+    next.assign(row() * row(), -1);
+    for (int i = 1; i <= N; ++i) {
+        for (auto& entry : nodes[i].distanceVector) dist[i * row() + entry.first] = entry.second;
+        for (auto& entry : nodes[i].nextHop) next[i * row() + entry.first] = entry.second;
+    }
+}
+
+void FlatTables::store(vector<Node>& nodes) const {
+    for (int i = 1; i <= N; ++i) {
+        for (int j = 1; j <= N; ++j) {
+            nodes[i].distanceVector[j] = dist[i * row() + j];
+            nodes[i].nextHop[j] = next[i * row() + j];
+        }
+    }
+}
+
+RowSource mapRows(const vector<Node>& nodes, int N) {
+    return [&nodes, N](const RowVisitor& visit) {
+        vector<int> dist(N + 1), next(N + 1);
+        for (int i = 1; i <= N; ++i) {
+            fill(dist.begin(), dist.end(), INFINITY);
+            fill(next.begin(), next.end(), -1);
+            for (auto& entry : nodes[i].distanceVector) dist[entry.first] = entry.second;
+            for (auto& entry : nodes[i].nextHop) next[entry.first] = entry.second;
+            visit(i, dist.data(), next.data());
+        }
+        return true;
+    };
+}
+
+long long advertisementsPerRound(const vector<Node>& nodes, int N) {
+    long long messages = 0;
+    for (int i = 1; i <= N; ++i) {
+        messages += nodes[i].neighbors.size();
+    }
+    return messages;
+}
+
+vector<vector<int>> pairNeighborEntries(const vector<Node>& nodes, int N) {
+    vector<vector<int>> peer(N + 1);
+    for (int u = 1; u <= N; ++u) {
+        const vector<int>& out = nodes[u].neighbors;
+        peer[u].assign(out.size(), -1);
+        for (size_t k = 0; k < out.size(); ++k) {
+            int v = out[k];
+            int occurrence = count(out.begin(), out.begin() + k, v);
+            const vector<int>& in = nodes[v].neighbors;
+            for (size_t m = 0; m < in.size(); ++m) {
+                if (in[m] == u && occurrence-- == 0) {
+                    peer[u][k] = m;
+                    break;
+                }
+            }
+        }
+    }
+    return peer;
+}
+
+int runEngine(vector<Node>& nodes, int N, int method, const SimOptions& options,
+              bool afterFailure, MetricsRecorder& metrics) {
+    if (options.engine == "partitioned") {
+        return runPartitioned(nodes, N, method, options.processes, afterFailure, metrics);
+    }
+    if (options.engine == "threaded") {
+        return runThreaded(nodes, N, method, options.threads, afterFailure, metrics);
+    }
+    if (options.engine == "actors") {
+        return runActors(nodes, N, method, afterFailure, metrics);
+    }
+    if (options.engine == "wire") {
+        string prefix = options.wirePrefix + (afterFailure ? "_after_failure" : "");
+        return runWire(nodes, N, method, prefix, afterFailure, metrics);
+    }
+    if (options.engine == "jacobi" || options.engine == "gauss-seidel") {
+        FlatTables tables;
+        tables.load(nodes, N);
+        SweepMode mode = options.engine == "jacobi" ? SWEEP_JACOBI : SWEEP_GAUSS_SEIDEL;
+        int rounds = runSweep(tables, nodes, method, mode, options.threads, options.orderSeed,
+                              afterFailure, metrics);
+        tables.store(nodes);
+        return rounds;
+    }
+    if (options.engine == "ecmp") {
+        FlatTables tables;
+        tables.load(nodes, N);
+        EcmpTables ecmp;
+        ecmp.maxWays = options.ecmpWays;
+        ecmp.composite = options.composite;
+        ecmp.load(tables);
+        int rounds = runEcmp(ecmp, nodes, method, afterFailure, metrics);
+        printEcmpRoutes(ecmp);
+        ecmp.store(tables);
+        tables.store(nodes);
+        return rounds;
+    }
+    cerr << "Unknown engine " << options.engine << "\n";
+    return -1;
+}
@@ -0,0 +1,68 @@
+#ifndef ENGINE_HPP
+#define ENGINE_HPP
+#include "defs.hpp"
+
+// Threshold used by checkCountToInfinity to flag a count-to-infinity episode
+const int COUNT_TO_INFINITY_LIMIT = 100;
+
+// Cost a router advertises to neighbour `to` for `dest`, given its own cost and
+// next hop for that destination, under the given method
+// (1 = none, 2 = poisoned reverse, 3 = split horizon).
+// Returns -1 when the entry is withheld from the advertisement (split horizon).
+inline int advertisedCost(int to, int dest, int cost, int nextHop, int method) {
+    if (method != 1 && nextHop == to && dest != to) {
+        return method == 2 ? INFINITY : -1;
+    }
+    return cost;
+}
+
+// Recomputes the distance vector of router `self` from its neighbours' rows.
+// Rows are indexed by destination (0..N). selfDist/selfNext hold the current row,
+// nbrDist[k]/nbrNext[k] the rows of neighbors[k]. The result is written to
+// outDist/outNext; returns true if any cost changed.
+bool relaxRouter(int self, int N, int method, const std::vector<int>& neighbors,
+                 const int* selfDist, const int* selfNext,
+                 const int* const* nbrDist, const int* const* nbrNext,
+                 int* outDist, int* outNext);
+
+// Routing tables of all routers as flat rows, row-major by router:
+// router i's cost to j is dist[i * (N + 1) + j] (row 0 and column 0 unused)
+struct FlatTables {
+    int N = 0;
+    std::vector<int> dist;
+    std::vector<int> next;
+
+    size_t row() const { return N + 1; }
+    int* distRow(int i) { return &dist[i * row()]; }
+    int* nextRow(int i) { return &next[i * row()]; }
+    const int* distRow(int i) const { return &dist[i * row()]; }
+    const int* nextRow(int i) const { return &next[i * row()]; }
+
+    // Copies the map-based tables of routers 1..N in and out
+    void load(const std::vector<Node>& nodes, int routers);
+    void store(std::vector<Node>& nodes) const;
+};
+
+// Rows of the map-based tables, flattened one router at a time with
+// FlatTables::load's defaults for missing entries
+RowSource mapRows(const std::vector<Node>& nodes, int N);
+
+struct SimOptions;
+class MetricsRecorder;
+
+// Advertisements sent per round: one per neighbour entry of every router
+long long advertisementsPerRound(const std::vector<Node>& nodes, int N);
+
+// Pairs the two ends of every link: peer[u][k] is the entry of u in the
+// neighbour list of v = nodes[u].neighbors[k]. Parallel links appear several
+// times in both lists and are paired in order.
+std::vector<std::vector<int>> pairNeighborEntries(const std::vector<Node>& nodes, int N);
+
+// Runs the engine selected in `options` in place of a part's own sweep loop.
+// After a link failure the run also stops on count-to-infinity, and any
+// reports are written under an "_after_failure" name. Every round is recorded
+// to `metrics`. Returns the number of rounds, or -1 on error.
+int runEngine(std::vector<Node>& nodes, int N, int method, const SimOptions& options,
+              bool afterFailure, MetricsRecorder& metrics);
+
+#endif // ENGINE_HPP
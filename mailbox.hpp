@@ -0,0 +1,84 @@
+#ifndef MAILBOX_HPP
+#define MAILBOX_HPP
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// One advertisement: a router's distance vector and next hops, shared by every
+// neighbour it was sent to. The producer fills it once; each receiver drops its
+// reference when it no longer needs the vector.
+struct Advert {
+    std::atomic<int> refs{0};
+    int round = 0;
+    int sender = 0;
+    std::vector<int> dist;   // Destination -> Cost (index 0 unused)
+    std::vector<int> next;   // Destination -> Next hop
+
+    void release() { refs.fetch_sub(1, std::memory_order_acq_rel); }
+};
+
+// Fixed set of advertisement buffers owned by one producer. Receivers only
+// decrement reference counts, so acquiring needs no lock and no shared free list:
+// the producer scans its own buffers for one nobody holds any more.
+class AdvertPool {
+public:
+    AdvertPool(int buffers, int N) : adverts(buffers) {
+        for (Advert& advert : adverts) {
+            advert.dist.resize(N + 1);
+            advert.next.resize(N + 1);
+        }
+    }
+
+    // Returns a free buffer with `refs` references, or nullptr if all are in use
+    Advert* acquire(int refs) {
+        for (Advert& advert : adverts) {
+            if (advert.refs.load(std::memory_order_acquire) == 0) {
+                advert.refs.store(refs, std::memory_order_relaxed);
+                return &advert;
+            }
+        }
+        return nullptr;
+    }
+
+private:
+    std::vector<Advert> adverts;
+};
+
+// Single-producer/single-consumer ring of advertisement pointers for one
+// directed link. Capacity must be a power of two.
+class Mailbox {
+public:
+    explicit Mailbox(unsigned capacity = 4) : slots(capacity), mask(capacity - 1) {}
+
+    Mailbox(const Mailbox&) = delete;
+    Mailbox& operator=(const Mailbox&) = delete;
+
+    // Producer side; returns false if the ring is full
+    bool push(Advert* advert) {
+        unsigned t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == slots.size()) return false;
+        slots[t & mask] = advert;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side; returns nullptr if the ring is empty
+    Advert* pop() {
+        unsigned h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return nullptr;
+        Advert* advert = slots[h & mask];
+        head.store(h + 1, std::memory_order_release);
+        return advert;
+    }
+
+private:
+    alignas(64) std::atomic<unsigned> head{0};   // Written by the consumer only
+    alignas(64) std::atomic<unsigned> tail{0};   // Written by the producer only
+    alignas(64) std::vector<Advert*> slots;
+    unsigned mask;
+};
+
+static_assert(std::atomic<unsigned>::is_always_lock_free, "mailboxes need lock-free atomics");
+static_assert(std::atomic<int>::is_always_lock_free, "advert reference counts need lock-free atomics");
+
+#endif // MAILBOX_HPP
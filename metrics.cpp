@@ -0,0 +1,199 @@
+#include "metrics.hpp"
+#include <cstdio>
+
+using namespace std;
+
+MetricsRecorder::~MetricsRecorder() {
+    endPhase();
+}
+
+bool MetricsRecorder::open(const string& path, bool showProgress) {
+    progress = showProgress;
+    if (!path.empty()) {
+        out.open(path);
+        if (!out.is_open()) {
+            cerr << "Error opening file " << path << "\n";
+            return false;
+        }
+        csv = path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0;
+        if (csv) {
+            out << "phase,round,changed_entries,changing_routers,max_finite_cost,loops,messages,seconds\n";
+        }
+    }
+    active = out.is_open() || progress;
+    return true;
+}
+
+void MetricsRecorder::beginPhase(const string& name, const vector<Node>& nodes, int N) {
+    endPhase();
+    phase = name;
+    round = 0;
+    if (!active) return;
+    flatten(nodes, N);
+    previous = flatDist;
+}
+
+void MetricsRecorder::beginPhase(const string& name) {
+    endPhase();
+    phase = name;
+    round = 0;
+}
+
+void MetricsRecorder::flatten(const vector<Node>& nodes, int N) {
+    size_t row = N + 1;
+    flatDist.assign(row * row, INFINITY);
+    flatNext.assign(row * row, -1);
+    for (int i = 1; i <= N; ++i) {
+        for (auto& entry : nodes[i].distanceVector) flatDist[i * row + entry.first] = entry.second;
+        for (auto& entry : nodes[i].nextHop) flatNext[i * row + entry.first] = entry.second;
+    }
+}
+
+bool MetricsRecorder::sampleDue() const {
+    return out.is_open() || !progressShown ||
+           chrono::steady_clock::now() - lastProgress >= chrono::milliseconds(100);
+}
+
+void MetricsRecorder::skipRound(long long messages, double seconds) {
+    last.round = ++round;
+    last.messages = messages;
+    last.seconds = seconds;
+    lastSampled = false;
+}
+
+void MetricsRecorder::recordRows(const vector<const int*>& dist, const vector<const int*>& next,
+                                 int N, long long messages, double seconds) {
+    if (!active) return;
+    if (!sampleDue()) {
+        skipRound(messages, seconds);
+        return;
+    }
+    size_t row = N + 1;
+    RoundMetrics metrics;
+    metrics.messages = messages;
+    metrics.seconds = seconds;
+
+    // Changes are counted against the previous sample: the previous round, or
+    // the previous redraw with --progress alone (or the phase's starting tables)
+    previous.resize(row * row, INFINITY);
+    for (int i = 1; i <= N; ++i) {
+        bool changed = false;
+        int* prev = &previous[i * row];
+        for (int j = 1; j <= N; ++j) {
+            int cost = dist[i][j];
+            if (cost != prev[j]) {
+                metrics.changedEntries++;
+                changed = true;
+            }
+            if (cost < INFINITY && cost > metrics.maxFiniteCost) metrics.maxFiniteCost = cost;
+            prev[j] = cost;
+        }
+        if (changed) metrics.changingRouters++;
+    }
+
+    // Forwarding loops: follow next hops towards each destination; a walk that
+    // runs into itself closes a new loop. Every router is walked once per destination.
+    // The progress line alone skips this, the most expensive statistic.
+    if (!out.is_open()) {
+        record(metrics);
+        return;
+    }
+    seen.assign(row, 0);
+    onWalk.assign(row, 0);
+    int walk = 0;
+    metrics.loops = 0;
+    for (int d = 1; d <= N; ++d) {
+        for (int v = 1; v <= N; ++v) {
+            if (v == d || seen[v] == d) continue;
+            ++walk;
+            int u = v;
+            while (u != d && u > 0 && seen[u] != d) {
+                seen[u] = d;
+                onWalk[u] = walk;
+                u = dist[u][d] < INFINITY ? next[u][d] : -1;
+            }
+            if (u != d && u > 0 && onWalk[u] == walk) metrics.loops++;
+        }
+    }
+
+    record(metrics);
+}
+
+void MetricsRecorder::recordNodes(const vector<Node>& nodes, int N, long long messages, double seconds) {
+    if (!active) return;
+    if (!sampleDue()) {
+        skipRound(messages, seconds);
+        return;
+    }
+    size_t row = N + 1;
+    flatten(nodes, N);
+    vector<const int*> dist(row), next(row);
+    for (int i = 1; i <= N; ++i) {
+        dist[i] = &flatDist[i * row];
+        next[i] = &flatNext[i * row];
+    }
+    recordRows(dist, next, N, messages, seconds);
+}
+
+void MetricsRecorder::record(const RoundMetrics& given) {
+    if (!active) return;
+    RoundMetrics metrics = given;
+    metrics.round = ++round;
+
+    if (out.is_open()) {
+        if (csv) {
+            out << phase << "," << metrics.round << "," << metrics.changedEntries << ","
+                << metrics.changingRouters << "," << metrics.maxFiniteCost << ","
+                << metrics.loops << "," << metrics.messages << "," << metrics.seconds << "\n";
+        } else {
+            out << "{\"phase\":\"" << phase << "\",\"round\":" << metrics.round
+                << ",\"changed_entries\":" << metrics.changedEntries
+                << ",\"changing_routers\":" << metrics.changingRouters
+                << ",\"max_finite_cost\":" << metrics.maxFiniteCost
+                << ",\"loops\":" << metrics.loops
+                << ",\"messages\":" << metrics.messages
+                << ",\"seconds\":" << metrics.seconds << "}\n";
+        }
+        // Flushed per round so the stream can be tailed during long runs
+        out.flush();
+    }
+
+    // The progress line is redrawn at most ten times a second
+    last = metrics;
+    lastSampled = true;
+    if (progress) {
+        auto now = chrono::steady_clock::now();
+        if (!progressShown || now - lastProgress >= chrono::milliseconds(100)) {
+            drawProgress();
+            lastProgress = now;
+        }
+    }
+}
+
+void MetricsRecorder::drawProgress() {
+    char line[160];
+    char loops[32] = "";
+    if (last.loops >= 0) snprintf(loops, sizeof(loops), "  loops %d", last.loops);
+    if (lastSampled) {
+        snprintf(line, sizeof(line),
+                 "\r[%s] round %d  changed %lld  routers %d  max cost %d%s  %.1f ms/round   ",
+                 phase.c_str(), last.round, last.changedEntries, last.changingRouters,
+                 last.maxFiniteCost, loops, last.seconds * 1000);
+    } else {
+        // A skipped round has no table statistics; the padding clears the old ones
+        snprintf(line, sizeof(line), "\r[%s] round %d  %.1f ms/round%60s",
+                 phase.c_str(), last.round, last.seconds * 1000, "");
+    }
+    cerr << line << flush;
+    progressShown = true;
+}
+
+void MetricsRecorder::endPhase() {
+    if (progressShown) {
+        // Always leave the final round of the phase on screen; with the progress
+        // line alone, a final round that was not sampled shows no table statistics
+        drawProgress();
+        cerr << "\n";
+        progressShown = false;
+    }
+}
@@ -0,0 +1,75 @@
+#ifndef METRICS_HPP
+#define METRICS_HPP
+#include "defs.hpp"
+#include <chrono>
+
+// Convergence statistics of one finished round
+struct RoundMetrics {
+    int round = 0;
+    long long changedEntries = 0;   // Distance entries that changed this round
+    int changingRouters = 0;        // Routers with at least one changed entry
+    int maxFiniteCost = 0;          // Largest cost below INFINITY
+    int loops = -1;                 // Forwarding loops over all destinations; -1 if not computed
+    long long messages = 0;         // Advertisements sent this round
+    double seconds = 0;             // Wall time of the round
+};
+
+// Writes one record per round to a metrics file (CSV if the path ends in
+// ".csv", NDJSON otherwise) and/or keeps a progress line on stderr.
+// Does nothing unless opened. With only the progress line, the tables are
+// examined only when a redraw is due; other rounds just advance the count.
+class MetricsRecorder {
+public:
+    ~MetricsRecorder();
+
+    // path may be empty when only the progress line is wanted
+    bool open(const std::string& path, bool progress);
+    bool enabled() const { return active; }
+
+    // Starts a new run ("initial", "after_failure") from the given tables;
+    // round numbers restart at 1
+    void beginPhase(const std::string& phase, const std::vector<Node>& nodes, int N);
+    // Same, for an engine that gathers its own statistics and only calls record()
+    void beginPhase(const std::string& phase);
+
+    // Records a round from the full tables; rows are indexed by destination (0..N)
+    // and dist[i]/next[i] belong to router i (index 0 unused)
+    void recordRows(const std::vector<const int*>& dist, const std::vector<const int*>& next,
+                    int N, long long messages, double seconds);
+
+    // Records a round from the map-based tables of a part's own sweep loop
+    void recordNodes(const std::vector<Node>& nodes, int N, long long messages, double seconds);
+
+    // Records a round whose statistics were gathered elsewhere
+    void record(const RoundMetrics& metrics);
+
+    // Ends the progress line of the current phase
+    void endPhase();
+
+private:
+    bool sampleDue() const;
+    void skipRound(long long messages, double seconds);
+    void flatten(const std::vector<Node>& nodes, int N);
+    void drawProgress();
+
+    bool active = false;
+    bool progress = false;
+    bool csv = false;
+    std::ofstream out;
+    std::string phase;
+    int round = 0;
+    std::vector<int> previous;         // Last round's costs, (N + 1) x (N + 1)
+    std::vector<int> flatDist, flatNext;
+    std::vector<int> seen, onWalk;
+    RoundMetrics last;
+    bool lastSampled = false;          // last holds the newest round's table statistics
+    std::chrono::steady_clock::time_point lastProgress;
+    bool progressShown = false;
+};
+
+// Seconds elapsed since `start`
+inline double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+#endif // METRICS_HPP
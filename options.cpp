@@ -0,0 +1,138 @@
+#include "options.hpp"
+#include "ecmp.hpp"
+#include <iostream>
+#include <cstdlib>
+
+using namespace std;
+
+static void printUsage(const char* program) {
+    cerr << "Usage: " << program << " [options] < topology\n"
+         << "  --procs P        run on P worker processes (partitioned engine)\n"
+         << "  --threads T      run on T threads with per-link mailboxes (threaded engine),\n"
+         << "                   or split --sweep jacobi rounds across T threads\n"
+         << "  --sweep MODE     jacobi (reads only the previous round) or gauss-seidel\n"
+         << "                   (reads in place) over flat tables\n"
+         << "  --order SEED     gauss-seidel visit order: 0 = router ids, else seeded shuffle\n"
+         << "  --ecmp K         keep up to K equal-cost next hops per destination (ecmp engine)\n"
+         << "  --composite      with --ecmp, break cost ties on hop count\n"
+         << "  --actors         run one coroutine actor per router (asynchronous, no rounds)\n"
+         << "  --wire PREFIX    send encoded advertisements and write per-round and\n"
+         << "                   per-link traffic to PREFIX_rounds.csv / PREFIX_links.csv\n"
+         << "  --save FILE      write a checkpoint of the converged tables\n"
+         << "  --load FILE      skip initial convergence and start from a checkpoint\n"
+         << "                   (stdin then only holds the failed link)\n"
+         << "  --metrics FILE   write per-round metrics (CSV if FILE ends in .csv, else NDJSON)\n"
+         << "  --progress       show a live progress line on stderr\n"
+         << "  --routers LIST   print only these routing tables, e.g. 1,4,10-20\n";
+}
+
+// Parses "1,4,10-20" into id ranges, in list order. Ranges are kept as
+// given; ids past the topology's router count are reported when printing.
+static bool parseRouterList(const string& list, RouterRanges& routers) {
+    size_t pos = 0;
+    while (pos < list.size()) {
+        size_t end = list.find(',', pos);
+        if (end == string::npos) end = list.size();
+        string item = list.substr(pos, end - pos);
+        size_t dash = item.find('-');
+        int first = atoi(item.substr(0, dash).c_str());
+        int last = dash == string::npos ? first : atoi(item.substr(dash + 1).c_str());
+        if (first < 1 || last < first) return false;
+        routers.push_back({first, last});
+        pos = end + 1;
+    }
+    return !routers.empty();
+}
+
+// Records the engine chosen by `flag`. Only one engine flag may be given.
+static bool selectEngine(const string& flag, const string& engine, string& engineFlag,
+                         SimOptions& options) {
+    if (!engineFlag.empty()) {
+        cerr << flag << " conflicts with " << engineFlag << ": choose one engine.\n";
+        return false;
+    }
+    engineFlag = flag;
+    options.engine = engine;
+    return true;
+}
+
+bool parseOptions(int argc, char* argv[], SimOptions& options) {
+    bool threadsGiven = false;
+    bool orderGiven = false;
+    string engineFlag;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--procs" && i + 1 < argc) {
+            options.processes = atoi(argv[++i]);
+            if (options.processes < 1) {
+                cerr << "--procs must be at least 1.\n";
+                return false;
+            }
+            if (!selectEngine(arg, "partitioned", engineFlag, options)) return false;
+        } else if (arg == "--threads" && i + 1 < argc) {
+            options.threads = atoi(argv[++i]);
+            if (options.threads < 1) {
+                cerr << "--threads must be at least 1.\n";
+                return false;
+            }
+            threadsGiven = true;
+        } else if (arg == "--sweep" && i + 1 < argc) {
+            string mode = argv[++i];
+            if (mode != "jacobi" && mode != "gauss-seidel") {
+                cerr << "--sweep must be jacobi or gauss-seidel.\n";
+                return false;
+            }
+            if (!selectEngine(arg, mode, engineFlag, options)) return false;
+        } else if (arg == "--ecmp" && i + 1 < argc) {
+            options.ecmpWays = atoi(argv[++i]);
+            if (options.ecmpWays < 1 || options.ecmpWays > MAX_ECMP_WAYS) {
+                cerr << "--ecmp must be between 1 and " << MAX_ECMP_WAYS << ".\n";
+                return false;
+            }
+            if (!selectEngine(arg, "ecmp", engineFlag, options)) return false;
+        } else if (arg == "--composite") {
+            options.composite = true;
+        } else if (arg == "--order" && i + 1 < argc) {
+            options.orderSeed = strtoull(argv[++i], nullptr, 10);
+            orderGiven = true;
+        } else if (arg == "--actors") {
+            if (!selectEngine(arg, "actors", engineFlag, options)) return false;
+        } else if (arg == "--wire" && i + 1 < argc) {
+            options.wirePrefix = argv[++i];
+            if (!selectEngine(arg, "wire", engineFlag, options)) return false;
+        } else if (arg == "--save" && i + 1 < argc) {
+            options.saveCheckpoint = argv[++i];
+        } else if (arg == "--load" && i + 1 < argc) {
+            options.loadCheckpoint = argv[++i];
+        } else if (arg == "--metrics" && i + 1 < argc) {
+            options.metricsPath = argv[++i];
+        } else if (arg == "--routers" && i + 1 < argc) {
+            if (!parseRouterList(argv[++i], options.routers)) {
+                cerr << "--routers takes ids and ranges such as 1,4,10-20.\n";
+                return false;
+            }
+        } else if (arg == "--progress") {
+            options.progress = true;
+        } else {
+            printUsage(argv[0]);
+            return false;
+        }
+    }
+    if (options.composite && options.engine != "ecmp") {
+        cerr << "--composite needs --ecmp.\n";
+        return false;
+    }
+    if (orderGiven && options.engine != "gauss-seidel") {
+        cerr << "--order needs --sweep gauss-seidel.\n";
+        return false;
+    }
+    if (threadsGiven && options.engine != "sweep" && options.engine != "jacobi") {
+        cerr << "--threads runs the threaded engine on its own, or goes with --sweep jacobi.\n";
+        return false;
+    }
+    // --threads on its own selects the mailbox engine
+    if (threadsGiven && options.engine == "sweep") {
+        options.engine = "threaded";
+    }
+    return true;
+}
@@ -0,0 +1,27 @@
+#ifndef OPTIONS_HPP
+#define OPTIONS_HPP
+#include "defs.hpp"
+#include <cstdint>
+#include <string>
+
+// Command line options shared by Part1, Part2 and Part3
+struct SimOptions {
+    std::string engine = "sweep";   // sweep (the part's own loop), partitioned, threaded, wire,
+                                    // jacobi, gauss-seidel, ecmp or actors
+    int processes = 1;              // Worker processes for the partitioned engine
+    int threads = 1;                // Worker threads for the threaded and jacobi engines
+    uint64_t orderSeed = 0;         // Gauss-Seidel visit order: 0 = router ids, else seeded shuffle
+    int ecmpWays = 1;               // Equal-cost next hops kept by the ecmp engine
+    bool composite = false;         // ecmp engine compares (cost, hops) lexicographically
+    std::string wirePrefix;         // Traffic report prefix for the wire engine
+    std::string saveCheckpoint;     // Write converged tables here before the link failure
+    std::string loadCheckpoint;     // Start from these converged tables instead of stdin
+    std::string metricsPath;        // Per-round metrics stream (.csv, otherwise NDJSON)
+    bool progress = false;          // Live progress line on stderr
+    RouterRanges routers;           // Routing tables to print; empty = all
+};
+
+// Parses argv into options. Prints usage and returns false on bad input.
+bool parseOptions(int argc, char* argv[], SimOptions& options);
+
+#endif // OPTIONS_HPP
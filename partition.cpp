@@ -0,0 +1,650 @@
+#include "partition.hpp"
+#include "engine.hpp"
+#include "metrics.hpp"
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <new>
+#include <queue>
+#include <sched.h>
+#include <signal.h>
+#ifdef __linux__
+#include <sys/prctl.h>
+#endif
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+
+void partitionRouters(const vector<Node>& nodes, int N, int parts, Partitioning& result) {
+    parts = max(1, min(parts, N));
+    result.parts = parts;
+    result.owner.assign(N + 1, -1);
+    result.members.assign(parts, vector<int>());
+
+    // Greedy graph growing: each partition starts from the lowest unassigned
+    // router and repeatedly absorbs the frontier router with the most links into it
+    vector<int> size(parts, 0);
+    vector<int> gain(N + 1, 0);
+    int assigned = 0;
+    int nextSeed = 1;
+    for (int p = 0; p < parts; ++p) {
+        int target = (N - assigned) / (parts - p);
+        priority_queue<pair<int, int>> frontier; // (gain, -router)
+        vector<int> touched;
+        while (size[p] < target) {
+            int v = -1;
+            while (!frontier.empty()) {
+                pair<int, int> top = frontier.top();
+                frontier.pop();
+                int u = -top.second;
+                if (result.owner[u] == -1 && top.first == gain[u]) {
+                    v = u;
+                    break;
+                }
+            }
+            if (v == -1) {
+                // Frontier exhausted (disconnected graph): start a new region
+                while (result.owner[nextSeed] != -1) ++nextSeed;
+                v = nextSeed;
+            }
+            result.owner[v] = p;
+            size[p]++;
+            assigned++;
+            for (int u : nodes[v].neighbors) {
+                if (result.owner[u] == -1) {
+                    gain[u]++;
+                    touched.push_back(u);
+                    frontier.push({gain[u], -u});
+                }
+            }
+        }
+        for (int u : touched) gain[u] = 0;
+    }
+
+    // Boundary refinement: move a router to the partition holding most of its
+    // links while that strictly reduces the cut and keeps sizes within the slack
+    int slack = max(1, N / parts / 32);
+    int maxSize = (N + parts - 1) / parts + slack;
+    int minSize = max(1, N / parts - slack);
+    vector<int> linksTo(parts, 0);
+    for (int pass = 0; pass < 8; ++pass) {
+        int moves = 0;
+        for (int v = 1; v <= N; ++v) {
+            int from = result.owner[v];
+            for (int u : nodes[v].neighbors) linksTo[result.owner[u]]++;
+            int best = from;
+            for (int u : nodes[v].neighbors) {
+                int p = result.owner[u];
+                if (linksTo[p] > linksTo[best] && size[p] < maxSize) best = p;
+            }
+            if (best != from && size[from] > minSize) {
+                result.owner[v] = best;
+                size[from]--;
+                size[best]++;
+                moves++;
+            }
+            for (int u : nodes[v].neighbors) linksTo[result.owner[u]] = 0;
+            linksTo[from] = 0;
+        }
+        if (moves == 0) break;
+    }
+
+    result.cutEdges = 0;
+    for (int v = 1; v <= N; ++v) {
+        result.members[result.owner[v]].push_back(v);
+        for (int u : nodes[v].neighbors) {
+            if (v < u && result.owner[u] != result.owner[v]) result.cutEdges++;
+        }
+    }
+}
+
+// Single-producer/single-consumer ring of fixed-size slots living in shared memory.
+// Each slot carries one boundary router's row: [round][router][dist 0..N][next 0..N]
+struct RingHeader {
+    alignas(64) atomic<unsigned> head;   // Next slot the consumer reads
+    alignas(64) atomic<unsigned> tail;   // Next slot the producer writes
+    alignas(64) unsigned capacity;
+    unsigned slotInts;
+
+    int* slot(unsigned index) {
+        return reinterpret_cast<int*>(this + 1) + size_t(index % capacity) * slotInts;
+    }
+};
+
+static_assert(atomic<unsigned>::is_always_lock_free, "shared-memory rings need lock-free atomics");
+static_assert(atomic<int>::is_always_lock_free, "shared-memory control block needs lock-free atomics");
+static_assert(atomic<long long>::is_always_lock_free, "shared-memory control block needs lock-free atomics");
+
+// Commands the coordinator gives the workers, one at a time
+enum WorkerCommand {
+    RUN_ROUND,
+    FAIL_LINK,
+    SEND_ROWS,
+    STOP
+};
+
+// Command and round control shared between the coordinator and the workers
+struct ControlBlock {
+    alignas(64) atomic<int> ticket;      // Bumped for every command
+    int command;                         // The fields up to `finished` are published by the ticket
+    int round;                           // RUN_ROUND: tag of the round's boundary rows
+    int failSrc, failDest;               // FAIL_LINK: ends of the failed link
+    alignas(64) atomic<int> finished;    // Workers done with the current command
+    alignas(64) atomic<int> changed;     // Some distance changed this round
+    atomic<int> overLimit;               // Some cost passed the count-to-infinity limit
+    atomic<long long> changedEntries;    // Round statistics summed over the workers
+    atomic<int> changingRouters;
+    atomic<int> maxFiniteCost;
+};
+
+// Worker side: true once the coordinator is gone (the worker was reparented).
+// Checked every so many spins, so an orphaned worker exits instead of spinning.
+static bool parentGone(pid_t parent, unsigned& spins) {
+    return ++spins % 1024 == 0 && getppid() != parent;
+}
+
+// Returns false if the coordinator died while the ring was full
+static bool ringPush(RingHeader* ring, int round, int router, const int* dist, const int* next, int N,
+                     pid_t parent) {
+    unsigned tail = ring->tail.load(memory_order_relaxed);
+    unsigned spins = 0;
+    while (tail - ring->head.load(memory_order_acquire) == ring->capacity) {
+        if (parentGone(parent, spins)) return false;
+        sched_yield();
+    }
+    int* slot = ring->slot(tail);
+    slot[0] = round;
+    slot[1] = router;
+    memcpy(slot + 2, dist, (N + 1) * sizeof(int));
+    memcpy(slot + 3 + N, next, (N + 1) * sizeof(int));
+    ring->tail.store(tail + 1, memory_order_release);
+    return true;
+}
+
+// Pops the next slot if it was published before `round`; returns nullptr otherwise.
+// The slot stays valid until ringRelease.
+static const int* ringPeek(RingHeader* ring, int round) {
+    unsigned head = ring->head.load(memory_order_relaxed);
+    if (head == ring->tail.load(memory_order_acquire)) return nullptr;
+    const int* slot = ring->slot(head);
+    return slot[0] < round ? slot : nullptr;
+}
+
+static void ringRelease(RingHeader* ring) {
+    ring->head.store(ring->head.load(memory_order_relaxed) + 1, memory_order_release);
+}
+
+// Moves exactly `bytes` over a pipe; false on error or end of file
+static bool writeAll(int fd, const void* data, size_t bytes) {
+    const char* from = static_cast<const char*>(data);
+    while (bytes > 0) {
+        ssize_t done = write(fd, from, bytes);
+        if (done < 0 && errno == EINTR) continue;
+        if (done <= 0) return false;
+        from += done;
+        bytes -= done;
+    }
+    return true;
+}
+
+static bool readAll(int fd, void* data, size_t bytes) {
+    char* to = static_cast<char*>(data);
+    while (bytes > 0) {
+        ssize_t done = read(fd, to, bytes);
+        if (done < 0 && errno == EINTR) continue;
+        if (done <= 0) return false;
+        to += done;
+        bytes -= done;
+    }
+    return true;
+}
+
+// Per-run layout of the shared mapping and the boundary exchange plan
+struct SharedRun {
+    int N;
+    int method;
+    Partitioning parts;
+    vector<vector<int>> neighbors;           // Router -> neighbours; each process has its own copy
+    vector<vector<vector<int>>> sendLists;   // [from][to] -> boundary routers to publish
+    vector<vector<RingHeader*>> rings;       // [from][to], nullptr if no boundary
+    ControlBlock* control;
+    void* base = nullptr;                    // The shared mapping
+    size_t bytes = 0;
+    pid_t parent = 0;                        // The coordinator
+    int resultFd = -1;                       // Worker's end of its result pipe
+    const vector<Node>* startTables = nullptr;   // Initial rows, read by the workers after fork;
+    const vector<Edge>* startEdges = nullptr;    // from the maps, otherwise from the links
+    vector<pid_t> workers;                   // Coordinator side from here on
+    vector<int> results;                     // Read ends of the result pipes
+    int round = 0;                           // Last round tag, counted across phases
+    long long messages = 0;                  // Advertisements per round
+    bool failed = false;
+};
+
+// Runs one partition: its initial rows, then the coordinator's commands until
+// STOP. Returns false if rows could not be sent back, or if the coordinator died.
+static bool runWorker(SharedRun& run, int part) {
+    int N = run.N;
+    size_t row = N + 1;
+    const vector<int>& owned = run.parts.members[part];
+    vector<vector<int>>& neighbors = run.neighbors;
+
+    // Local rows: owned routers first, then ghost copies of foreign neighbours
+    vector<int> localOf(N + 1, -1);
+    vector<int> local(owned);
+    for (size_t k = 0; k < owned.size(); ++k) localOf[owned[k]] = k;
+    for (int r : owned) {
+        for (int u : neighbors[r]) {
+            if (localOf[u] == -1) {
+                localOf[u] = local.size();
+                local.push_back(u);
+            }
+        }
+    }
+
+    vector<int> dist(local.size() * row, INFINITY), next(local.size() * row, -1);
+    if (run.startTables != nullptr) {
+        const vector<Node>& nodes = *run.startTables;
+        for (size_t k = 0; k < local.size(); ++k) {
+            int r = local[k];
+            for (int j = 1; j <= N; ++j) {
+                dist[k * row + j] = nodes[r].distanceVector.at(j);
+                next[k * row + j] = nodes[r].nextHop.at(j);
+            }
+        }
+    } else {
+        // As initializeDistanceVectors: the route to itself, then the links in input order
+        for (size_t k = 0; k < local.size(); ++k) {
+            dist[k * row + local[k]] = 0;
+            next[k * row + local[k]] = local[k];
+        }
+        for (const Edge& edge : *run.startEdges) {
+            if (localOf[edge.src] != -1) {
+                dist[localOf[edge.src] * row + edge.dest] = edge.cost;
+                next[localOf[edge.src] * row + edge.dest] = edge.dest;
+            }
+            if (localOf[edge.dest] != -1) {
+                dist[localOf[edge.dest] * row + edge.src] = edge.cost;
+                next[localOf[edge.dest] * row + edge.src] = edge.src;
+            }
+        }
+    }
+
+    vector<int> newDist(owned.size() * row), newNext(owned.size() * row);
+    vector<vector<const int*>> nbrDist(owned.size()), nbrNext(owned.size());
+    auto linkNeighbors = [&](size_t k) {
+        nbrDist[k].clear();
+        nbrNext[k].clear();
+        for (int u : neighbors[owned[k]]) {
+            nbrDist[k].push_back(&dist[localOf[u] * row]);
+            nbrNext[k].push_back(&next[localOf[u] * row]);
+        }
+    };
+    for (size_t k = 0; k < owned.size(); ++k) linkNeighbors(k);
+
+    // Copies the boundary rows published before `round` into the ghost rows
+    auto receive = [&](int round) {
+        for (int from = 0; from < run.parts.parts; ++from) {
+            RingHeader* ring = run.rings[from][part];
+            if (ring == nullptr) continue;
+            const int* slot;
+            while ((slot = ringPeek(ring, round)) != nullptr) {
+                size_t k = localOf[slot[1]];
+                memcpy(&dist[k * row], slot + 2, row * sizeof(int));
+                memcpy(&next[k * row], slot + 3 + N, row * sizeof(int));
+                ringRelease(ring);
+            }
+        }
+    };
+
+    ControlBlock* control = run.control;
+    int lastTicket = 0;
+    while (true) {
+        int ticket;
+        unsigned spins = 0;
+        while ((ticket = control->ticket.load(memory_order_acquire)) == lastTicket) {
+            if (parentGone(run.parent, spins)) return false;
+            sched_yield();
+        }
+        lastTicket = ticket;
+        int command = control->command;
+        if (command == STOP) return true;
+
+        if (command == FAIL_LINK) {
+            // Bring the ghosts up to date first, so the failure is not overwritten
+            // by rows published before it
+            receive(INT_MAX);
+            int a = control->failSrc, b = control->failDest;
+            if (a >= 1 && a <= N && b >= 1 && b <= N) {
+                for (int end = 0; end < 2; ++end) {
+                    int self = end ? b : a, other = end ? a : b;
+                    vector<int>& list = neighbors[self];
+                    list.erase(remove(list.begin(), list.end(), other), list.end());
+                    if (localOf[self] == -1) continue;
+                    size_t k = localOf[self];
+                    dist[k * row + other] = INFINITY;
+                    next[k * row + other] = -1;
+                    if (k < owned.size()) linkNeighbors(k);
+                }
+            }
+        } else if (command == SEND_ROWS) {
+            // Owned rows in member order: the distances, then the next hops
+            for (size_t k = 0; k < owned.size(); ++k) {
+                if (!writeAll(run.resultFd, &dist[k * row], row * sizeof(int)) ||
+                    !writeAll(run.resultFd, &next[k * row], row * sizeof(int))) {
+                    return false;
+                }
+            }
+        } else {
+            int round = control->round;
+            receive(round);
+
+            bool changed = false;
+            int changingRouters = 0;
+            long long changedEntries = 0;
+            for (size_t k = 0; k < owned.size(); ++k) {
+                if (relaxRouter(owned[k], N, run.method, neighbors[owned[k]],
+                                &dist[k * row], &next[k * row],
+                                nbrDist[k].data(), nbrNext[k].data(),
+                                &newDist[k * row], &newNext[k * row])) {
+                    changed = true;
+                    changingRouters++;
+                    for (size_t j = 1; j < row; ++j) {
+                        changedEntries += dist[k * row + j] != newDist[k * row + j];
+                    }
+                }
+            }
+            memcpy(dist.data(), newDist.data(), newDist.size() * sizeof(int));
+            memcpy(next.data(), newNext.data(), newNext.size() * sizeof(int));
+
+            bool overLimit = false;
+            int maxFiniteCost = 0;
+            for (size_t k = 0; k < owned.size() * row; ++k) {
+                if (dist[k] < INFINITY) {
+                    maxFiniteCost = max(maxFiniteCost, dist[k]);
+                    if (dist[k] > COUNT_TO_INFINITY_LIMIT) overLimit = true;
+                }
+            }
+
+            // Publish boundary rows for the neighbouring partitions
+            for (int to = 0; to < run.parts.parts; ++to) {
+                for (int r : run.sendLists[part][to]) {
+                    size_t k = localOf[r];
+                    if (!ringPush(run.rings[part][to], round, r, &dist[k * row], &next[k * row], N,
+                                  run.parent)) {
+                        return false;
+                    }
+                }
+            }
+
+            if (changed) control->changed.store(1, memory_order_relaxed);
+            if (overLimit) control->overLimit.store(1, memory_order_relaxed);
+            control->changedEntries.fetch_add(changedEntries, memory_order_relaxed);
+            control->changingRouters.fetch_add(changingRouters, memory_order_relaxed);
+            int seen = control->maxFiniteCost.load(memory_order_relaxed);
+            while (maxFiniteCost > seen &&
+                   !control->maxFiniteCost.compare_exchange_weak(seen, maxFiniteCost, memory_order_relaxed)) {
+            }
+        }
+        control->finished.fetch_add(1, memory_order_acq_rel);
+    }
+}
+
+// Hands the workers the command set up in the control block
+static void issue(SharedRun& run, WorkerCommand command) {
+    run.control->command = command;
+    run.control->finished.store(0, memory_order_relaxed);
+    run.control->ticket.fetch_add(1, memory_order_acq_rel);
+}
+
+// Waits for every worker to finish the current command; returns false if one died
+static bool waitForWorkers(SharedRun& run) {
+    unsigned spins = 0;
+    while (run.control->finished.load(memory_order_acquire) < run.parts.parts) {
+        if (++spins % 1024 == 0) {
+            for (pid_t pid : run.workers) {
+                if (kill(pid, 0) != 0 || waitpid(pid, nullptr, WNOHANG) == pid) return false;
+            }
+        }
+        sched_yield();
+    }
+    return true;
+}
+
+// Reports a failed command and kills the remaining workers; stop() reaps them
+static void abandon(SharedRun& run, const string& when) {
+    cerr << "A worker process failed " << when << "\n";
+    for (pid_t pid : run.workers) kill(pid, SIGKILL);
+    run.failed = true;
+}
+
+// Partitions the routers, maps the rings and forks the workers
+static bool launch(SharedRun& run, const vector<Node>& nodes, int N, int method, int processes) {
+    run.N = N;
+    run.method = method;
+    run.neighbors.assign(N + 1, vector<int>());
+    for (int r = 1; r <= N; ++r) {
+        run.neighbors[r] = nodes[r].neighbors;
+        run.messages += nodes[r].neighbors.size();
+    }
+    partitionRouters(nodes, N, processes, run.parts);
+    int parts = run.parts.parts;
+
+    run.sendLists.assign(parts, vector<vector<int>>(parts));
+    for (int r = 1; r <= N; ++r) {
+        int from = run.parts.owner[r];
+        for (int u : nodes[r].neighbors) {
+            vector<int>& list = run.sendLists[from][run.parts.owner[u]];
+            if (run.parts.owner[u] != from && (list.empty() || list.back() != r)) {
+                list.push_back(r);
+            }
+        }
+    }
+
+    // One shared mapping: the control block, then the rings. Results come back
+    // through a pipe per worker, so no process ever holds a full flat table.
+    size_t row = N + 1;
+    unsigned slotInts = 2 + 2 * row;
+    size_t bytes = sizeof(ControlBlock);
+    vector<vector<size_t>> ringOffset(parts, vector<size_t>(parts, 0));
+    for (int from = 0; from < parts; ++from) {
+        for (int to = 0; to < parts; ++to) {
+            size_t count = run.sendLists[from][to].size();
+            if (count == 0) continue;
+            ringOffset[from][to] = bytes;
+            // Room for two rounds: a fast producer may publish round r+1
+            // before the consumer has drained round r
+            bytes += sizeof(RingHeader) + 2 * count * slotInts * sizeof(int);
+            bytes = (bytes + 63) & ~size_t(63);
+        }
+    }
+
+    void* base = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        cerr << "Error mapping " << bytes << " bytes of shared memory\n";
+        return false;
+    }
+    run.base = base;
+    run.bytes = bytes;
+    char* mem = static_cast<char*>(base);
+    run.control = new (mem) ControlBlock();
+    run.rings.assign(parts, vector<RingHeader*>(parts, nullptr));
+    for (int from = 0; from < parts; ++from) {
+        for (int to = 0; to < parts; ++to) {
+            size_t count = run.sendLists[from][to].size();
+            if (count == 0) continue;
+            RingHeader* ring = new (mem + ringOffset[from][to]) RingHeader();
+            ring->capacity = 2 * count;
+            ring->slotInts = slotInts;
+            run.rings[from][to] = ring;
+        }
+    }
+
+    // Each worker only inherits the write end of its own pipe, so a worker that
+    // dies closes its pipe and the parent's read fails instead of hanging
+    run.parent = getpid();
+    for (int p = 0; p < parts; ++p) {
+        int fds[2];
+        if (pipe(fds) != 0) {
+            cerr << "Error creating the result pipe of worker process " << p << "\n";
+            for (pid_t pid : run.workers) kill(pid, SIGKILL);
+            run.failed = true;
+            return false;
+        }
+        pid_t pid = fork();
+        if (pid == 0) {
+            // Die with the coordinator; it may already be gone before prctl ran
+#ifdef __linux__
+            prctl(PR_SET_PDEATHSIG, SIGKILL);
+#endif
+            if (getppid() != run.parent) _exit(1);
+            for (int fd : run.results) close(fd);
+            close(fds[0]);
+            run.resultFd = fds[1];
+            _exit(runWorker(run, p) ? 0 : 1);
+        }
+        close(fds[1]);
+        if (pid < 0) {
+            cerr << "Error starting worker process " << p << "\n";
+            close(fds[0]);
+            for (pid_t worker : run.workers) kill(worker, SIGKILL);
+            run.failed = true;
+            return false;
+        }
+        run.workers.push_back(pid);
+        run.results.push_back(fds[0]);
+    }
+    return true;
+}
+
+PartitionedTables::PartitionedTables() {}
+
+PartitionedTables::~PartitionedTables() {
+    stop();
+}
+
+bool PartitionedTables::start(const vector<Node>& nodes, const vector<Edge>& edges, int N, int method,
+                              int processes) {
+    stop();
+    run.reset(new SharedRun());
+    run->startEdges = &edges;
+    if (launch(*run, nodes, N, method, processes)) return true;
+    stop();
+    return false;
+}
+
+bool PartitionedTables::start(const vector<Node>& nodes, int N, int method, int processes) {
+    stop();
+    run.reset(new SharedRun());
+    run->startTables = &nodes;
+    if (launch(*run, nodes, N, method, processes)) return true;
+    stop();
+    return false;
+}
+
+int PartitionedTables::converge(bool stopOnCountToInfinity, MetricsRecorder& metrics) {
+    if (!run || run->failed) return -1;
+    ControlBlock* control = run->control;
+    int rounds = 0;
+    while (true) {
+        ++rounds;
+        auto start = chrono::steady_clock::now();
+        control->changed.store(0, memory_order_relaxed);
+        control->overLimit.store(0, memory_order_relaxed);
+        control->changedEntries.store(0, memory_order_relaxed);
+        control->changingRouters.store(0, memory_order_relaxed);
+        control->maxFiniteCost.store(0, memory_order_relaxed);
+        control->round = ++run->round;
+        issue(*run, RUN_ROUND);
+        if (!waitForWorkers(*run)) {
+            abandon(*run, "during round " + to_string(rounds));
+            return -1;
+        }
+
+        RoundMetrics stats;
+        stats.changedEntries = control->changedEntries.load(memory_order_relaxed);
+        stats.changingRouters = control->changingRouters.load(memory_order_relaxed);
+        stats.maxFiniteCost = control->maxFiniteCost.load(memory_order_relaxed);
+        stats.messages = run->messages;
+        stats.seconds = secondsSince(start);
+        metrics.record(stats);
+        if (!control->changed.load(memory_order_relaxed)) break;
+        if (stopOnCountToInfinity && control->overLimit.load(memory_order_relaxed)) break;
+    }
+    return rounds;
+}
+
+bool PartitionedTables::failLink(int a, int b) {
+    if (!run || run->failed) return false;
+    if (a >= 1 && a <= run->N && b >= 1 && b <= run->N) {
+        for (int end = 0; end < 2; ++end) {
+            vector<int>& list = run->neighbors[end ? b : a];
+            auto kept = remove(list.begin(), list.end(), end ? a : b);
+            run->messages -= list.end() - kept;
+            list.erase(kept, list.end());
+        }
+    }
+    run->control->failSrc = a;
+    run->control->failDest = b;
+    issue(*run, FAIL_LINK);
+    if (!waitForWorkers(*run)) {
+        abandon(*run, "while failing the link");
+        return false;
+    }
+    return true;
+}
+
+bool PartitionedTables::forEachRow(const RowVisitor& visit) {
+    if (!run || run->failed) return false;
+    issue(*run, SEND_ROWS);
+    // Members are ascending, so each pipe delivers its rows in id order
+    size_t row = run->N + 1;
+    vector<int> buffer(2 * row);
+    for (int i = 1; i <= run->N; ++i) {
+        if (!readAll(run->results[run->parts.owner[i]], buffer.data(), buffer.size() * sizeof(int))) {
+            abandon(*run, "while sending its rows");
+            return false;
+        }
+        visit(i, buffer.data(), buffer.data() + row);
+    }
+    if (!waitForWorkers(*run)) {
+        abandon(*run, "after sending its rows");
+        return false;
+    }
+    return true;
+}
+
+bool PartitionedTables::stop() {
+    if (!run) return true;
+    bool ok = !run->failed;
+    if (ok && !run->workers.empty()) issue(*run, STOP);
+    for (int fd : run->results) close(fd);
+    for (pid_t pid : run->workers) {
+        int status = 0;
+        if (waitpid(pid, &status, 0) == pid && (!WIFEXITED(status) || WEXITSTATUS(status) != 0)) {
+            ok = false;
+        }
+    }
+    if (!ok && !run->failed) cerr << "A worker process failed\n";
+    if (run->base != nullptr) munmap(run->base, run->bytes);
+    run.reset();
+    return ok;
+}
+
+int runPartitioned(vector<Node>& nodes, int N, int method, int processes,
+                   bool stopOnCountToInfinity, MetricsRecorder& metrics) {
+    PartitionedTables workers;
+    if (!workers.start(nodes, N, method, processes)) return -1;
+    int rounds = workers.converge(stopOnCountToInfinity, metrics);
+    if (rounds < 0) return -1;
+    bool copied = workers.forEachRow([&](int i, const int* dist, const int* next) {
+        for (int j = 1; j <= N; ++j) {
+            nodes[i].distanceVector[j] = dist[j];
+            nodes[i].nextHop[j] = next[j];
+        }
+    });
+    return workers.stop() && copied ? rounds : -1;
+}
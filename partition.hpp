@@ -0,0 +1,72 @@
+#ifndef PARTITION_HPP
+#define PARTITION_HPP
+#include "defs.hpp"
+#include <memory>
+
+class MetricsRecorder;
+struct SharedRun;
+
+// Assignment of routers to worker processes
+struct Partitioning {
+    int parts = 0;
+    std::vector<int> owner;                  // Router -> partition (index 0 unused)
+    std::vector<std::vector<int>> members;   // Partition -> routers, ascending
+    int cutEdges = 0;                        // Links whose ends are in different partitions
+};
+
+// Splits routers 1..N into `parts` balanced partitions, keeping the number of
+// cut links low (greedy graph growing followed by boundary refinement).
+void partitionRouters(const std::vector<Node>& nodes, int N, int parts, Partitioning& result);
+
+// Worker processes that hold the routing tables across a part's phases. Each
+// worker builds and keeps only its own routers' rows, plus copies of the rows
+// of their neighbours in other partitions, so the caller never holds the
+// N x N tables. Rows come back through a pipe per worker when asked for.
+class PartitionedTables {
+public:
+    PartitionedTables();
+    ~PartitionedTables();
+
+    // Partitions routers 1..N (only their neighbours are read) and starts
+    // `processes` workers, whose rows start from the links as in
+    // initializeDistanceVectors. Returns false on error.
+    bool start(const std::vector<Node>& nodes, const std::vector<Edge>& edges, int N, int method,
+               int processes);
+    // Same, with the rows taken from the map-based tables
+    bool start(const std::vector<Node>& nodes, int N, int method, int processes);
+
+    // Runs rounds until no distance changes, or, if stopOnCountToInfinity is
+    // set, until some cost passes the count-to-infinity limit. Every round
+    // reads the previous round's tables. Per-round statistics go to `metrics`
+    // (forwarding loops are not computed, as no process sees the whole table).
+    // Returns the number of rounds, or -1 on error.
+    int converge(bool stopOnCountToInfinity, MetricsRecorder& metrics);
+
+    // Fails every link between a and b as the parts do: both routers drop each
+    // other as neighbours and set their route to the other to INFINITY.
+    // Returns false on error.
+    bool failLink(int a, int b);
+
+    // Streams the rows of routers 1..N in id order. Returns false on error.
+    bool forEachRow(const RowVisitor& visit);
+    RowSource rows() {
+        return [this](const RowVisitor& visit) { return forEachRow(visit); };
+    }
+
+    // Stops the workers. Returns false if any of them failed.
+    bool stop();
+
+private:
+    std::unique_ptr<SharedRun> run;
+};
+
+// Runs DVR rounds on `processes` forked workers until no distance changes, or,
+// if stopOnCountToInfinity is set, until some cost passes the count-to-infinity
+// limit. Every round reads the previous round's tables. The converged tables
+// are copied back into `nodes`. Per-round statistics go to `metrics` (forwarding
+// loops are not computed, as no process sees the whole table).
+// Returns the number of rounds, or -1 on error.
+int runPartitioned(std::vector<Node>& nodes, int N, int method, int processes,
+                   bool stopOnCountToInfinity, MetricsRecorder& metrics);
+
+#endif // PARTITION_HPP
@@ -0,0 +1,185 @@
+#include "routes.hpp"
+#include <cerrno>
+#include <cstring>
+
+using namespace std;
+
+OutputBuffer::OutputBuffer(int fd, size_t flushBytes) : fd(fd), flushBytes(flushBytes) {
+    buffer.resize(fd >= 0 ? flushBytes + 64 : 4096);
+}
+
+OutputBuffer::~OutputBuffer() {
+    flush();
+}
+
+char* OutputBuffer::reserve(size_t bytes) {
+    if (fd >= 0 && used + bytes > flushBytes) flush();
+    if (used + bytes > buffer.size()) buffer.resize(max(buffer.size() * 2, used + bytes));
+    return buffer.data() + used;
+}
+
+void OutputBuffer::put(const char* text, size_t length) {
+    memcpy(reserve(length), text, length);
+    used += length;
+}
+
+void OutputBuffer::put(const char* text) {
+    put(text, strlen(text));
+}
+
+// Two digits per step from a 200-byte table
+static const char DIGIT_PAIRS[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+void OutputBuffer::putInt(int value) {
+    char* out = reserve(11);
+    unsigned magnitude = value < 0 ? 0u - unsigned(value) : unsigned(value);
+    char digits[10];
+    int pos = 10;
+    while (magnitude >= 100) {
+        unsigned pair = (magnitude % 100) * 2;
+        magnitude /= 100;
+        digits[--pos] = DIGIT_PAIRS[pair + 1];
+        digits[--pos] = DIGIT_PAIRS[pair];
+    }
+    if (magnitude >= 10) {
+        digits[--pos] = DIGIT_PAIRS[magnitude * 2 + 1];
+        digits[--pos] = DIGIT_PAIRS[magnitude * 2];
+    } else {
+        digits[--pos] = char('0' + magnitude);
+    }
+    size_t length = 0;
+    if (value < 0) out[length++] = '-';
+    memcpy(out + length, digits + pos, 10 - pos);
+    used += length + 10 - pos;
+}
+
+bool OutputBuffer::flush() {
+    if (fd < 0) return !failed;
+    size_t done = 0;
+    while (done < used && !failed) {
+        ssize_t written = write(fd, buffer.data() + done, used - done);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            cerr << "Error writing routing tables: " << strerror(errno) << "\n";
+            failed = true;
+        } else {
+            done += written;
+        }
+    }
+    used = 0;
+    return !failed;
+}
+
+static void writeRouter(int i, int N, const int* dist, const int* next, OutputBuffer& out) {
+    out.put("Routing table for Node ");
+    out.putInt(i);
+    out.put(":\nDestination\tCost\tNext Hop\n");
+    for (int j = 1; j <= N; ++j) {
+        out.putInt(j);
+        if (dist[j] >= INFINITY) {
+            out.put("\t\tINF\t-\n", 8);
+        } else {
+            out.put("\t\t", 2);
+            out.putInt(dist[j]);
+            out.put("\t", 1);
+            out.putInt(next[j]);
+            out.put("\n", 1);
+        }
+    }
+    out.put("\n", 1);
+}
+
+// Calls write(i) for every router, or for the listed ones in list order
+template <typename Write>
+static void forEachListed(int N, const RouterRanges& routers, Write write) {
+    if (routers.empty()) {
+        for (int i = 1; i <= N; ++i) write(i);
+        return;
+    }
+    for (auto& range : routers) {
+        int missing = max(range.first, N + 1);
+        if (missing == range.second) {
+            cerr << "Router " << missing << " does not exist.\n";
+        } else if (missing < range.second) {
+            cerr << "Routers " << missing << "-" << range.second << " do not exist.\n";
+        }
+        for (int i = range.first; i <= min(range.second, N); ++i) write(i);
+    }
+}
+
+void writeRoutingTables(const FlatTables& tables, const RouterRanges& routers, OutputBuffer& out) {
+    forEachListed(tables.N, routers, [&](int i) {
+        writeRouter(i, tables.N, tables.distRow(i), tables.nextRow(i), out);
+    });
+}
+
+void writeRoutingTables(const vector<Node>& nodes, int N, const RouterRanges& routers, OutputBuffer& out) {
+    // One router's row at a time, with FlatTables::load's defaults for missing entries
+    vector<int> dist(N + 1), next(N + 1);
+    forEachListed(N, routers, [&](int i) {
+        fill(dist.begin(), dist.end(), INFINITY);
+        fill(next.begin(), next.end(), -1);
+        for (auto& entry : nodes[i].distanceVector) dist[entry.first] = entry.second;
+        for (auto& entry : nodes[i].nextHop) next[entry.first] = entry.second;
+        writeRouter(i, N, dist.data(), next.data(), out);
+    });
+}
+
+bool writeRoutingTables(const RowSource& rows, int N, const RouterRanges& routers, OutputBuffer& out) {
+    if (routers.empty()) {
+        return rows([&](int i, const int* dist, const int* next) { writeRouter(i, N, dist, next, out); });
+    }
+    // Slot of each listed router in `kept`, -1 if not listed
+    size_t row = N + 1;
+    vector<int> slot(row, -1);
+    int listed = 0;
+    for (auto& range : routers) {
+        for (int i = range.first; i <= min(range.second, N); ++i) {
+            if (slot[i] == -1) slot[i] = listed++;
+        }
+    }
+    vector<int> kept(2 * row * listed);
+    bool ok = rows([&](int i, const int* dist, const int* next) {
+        if (slot[i] == -1) return;
+        memcpy(&kept[2 * row * slot[i]], dist, row * sizeof(int));
+        memcpy(&kept[2 * row * slot[i] + row], next, row * sizeof(int));
+    });
+    if (!ok) return false;
+    forEachListed(N, routers, [&](int i) {
+        writeRouter(i, N, &kept[2 * row * slot[i]], &kept[2 * row * slot[i] + row], out);
+    });
+    return true;
+}
+
+void RouteTable::build(const FlatTables& tables) {
+    N = tables.N;
+    size_t row = N + 1;
+    routes.assign(row * row, Route{INFINITY, -1});
+    towards.assign(row * row, -1);
+    for (int i = 1; i <= N; ++i) {
+        const int* dist = tables.distRow(i);
+        const int* next = tables.nextRow(i);
+        for (int j = 1; j <= N; ++j) {
+            if (dist[j] >= INFINITY) continue;
+            routes[i * row + j] = Route{dist[j], next[j]};
+            towards[j * row + i] = next[j];
+        }
+    }
+}
+
+bool RouteTable::path(int src, int dst, vector<int>& hops) const {
+    hops.clear();
+    if (src < 1 || src > N || dst < 1 || dst > N) return false;
+    const int* next = &towards[dst * size_t(N + 1)];
+    hops.push_back(src);
+    // A loop-free path visits each router at most once
+    for (int u = src; u != dst; ) {
+        u = next[u];
+        if (u < 1 || u > N || int(hops.size()) > N) return false;
+        hops.push_back(u);
+    }
+    return true;
+}
@@ -0,0 +1,76 @@
+#ifndef ROUTES_HPP
+#define ROUTES_HPP
+#include "engine.hpp"
+
+// Text buffer with hand-rolled integer formatting. With a file descriptor,
+// the text is handed to the kernel in large blocks: one write() for anything
+// under flushBytes. Without one (fd -1) it just grows and text() returns it.
+class OutputBuffer {
+public:
+    explicit OutputBuffer(int fd = -1, size_t flushBytes = 4 << 20);
+    ~OutputBuffer();
+
+    void put(const char* text, size_t length);
+    void put(const char* text);
+    void putInt(int value);
+
+    // Writes the buffered text to the descriptor. Returns false on a write error.
+    bool flush();
+
+    std::string text() const { return std::string(buffer.data(), used); }
+
+private:
+    char* reserve(size_t bytes);
+
+    int fd;
+    size_t flushBytes;
+    std::vector<char> buffer;
+    size_t used = 0;
+    bool failed = false;
+};
+
+// Formats routing tables in the same layout as printRoutingTables: every
+// router when `routers` is empty, otherwise only the listed ranges, in list
+// order. Ids past N are reported on stderr, once per range, and skipped.
+void writeRoutingTables(const FlatTables& tables, const RouterRanges& routers, OutputBuffer& out);
+
+// Same, straight from the map-based tables, flattening one router at a time
+void writeRoutingTables(const std::vector<Node>& nodes, int N, const RouterRanges& routers,
+                        OutputBuffer& out);
+
+// Same, from rows streamed in id order. Listed routers are gathered first so
+// they print in list order; only their rows are kept. Returns false if the
+// source failed.
+bool writeRoutingTables(const RowSource& rows, int N, const RouterRanges& routers, OutputBuffer& out);
+
+// Cost and next hop of one routing entry
+struct Route {
+    int cost;       // INFINITY when unreachable
+    int nextHop;    // -1 when unreachable
+};
+
+// Read-only query view of converged tables. lookup() is one array access;
+// path() walks next hops in a by-destination copy of the next-hop table, so
+// every hop of one walk reads the same row.
+class RouteTable {
+public:
+    void build(const FlatTables& tables);
+    int routers() const { return N; }
+
+    Route lookup(int src, int dst) const {
+        if (src < 1 || src > N || dst < 1 || dst > N) return Route{INFINITY, -1};
+        return routes[src * size_t(N + 1) + dst];
+    }
+
+    // Fills `hops` with the routers from src to dst, both included. Returns
+    // false when dst is unreachable or the next hops loop; `hops` then holds
+    // the walk up to that point.
+    bool path(int src, int dst, std::vector<int>& hops) const;
+
+private:
+    int N = 0;
+    std::vector<Route> routes;  // (N + 1) x (N + 1), row-major by source
+    std::vector<int> towards;   // (N + 1) x (N + 1), row-major by destination
+};
+
+#endif // ROUTES_HPP
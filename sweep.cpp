@@ -0,0 +1,134 @@
+#include "sweep.hpp"
+#include "barrier.hpp"
+#include "metrics.hpp"
+#include "topology.hpp"
+
+using namespace std;
+
+// Relaxes one router from the rows in `from` into outDist/outNext
+static bool relaxFrom(const FlatTables& from, const vector<Node>& nodes, int r, int method,
+                      vector<const int*>& nbrDist, vector<const int*>& nbrNext,
+                      int* outDist, int* outNext) {
+    nbrDist.clear();
+    nbrNext.clear();
+    for (int u : nodes[r].neighbors) {
+        nbrDist.push_back(from.distRow(u));
+        nbrNext.push_back(from.nextRow(u));
+    }
+    return relaxRouter(r, from.N, method, nodes[r].neighbors, from.distRow(r), from.nextRow(r),
+                       nbrDist.data(), nbrNext.data(), outDist, outNext);
+}
+
+static bool overCountLimit(const int* dist, int N) {
+    for (int j = 1; j <= N; ++j) {
+        if (dist[j] > COUNT_TO_INFINITY_LIMIT && dist[j] < INFINITY) return true;
+    }
+    return false;
+}
+
+static void recordRound(MetricsRecorder& metrics, const FlatTables& tables, long long messages,
+                        double seconds) {
+    if (!metrics.enabled()) return;
+    vector<const int*> dist(tables.row()), next(tables.row());
+    for (int i = 1; i <= tables.N; ++i) {
+        dist[i] = tables.distRow(i);
+        next[i] = tables.nextRow(i);
+    }
+    metrics.recordRows(dist, next, tables.N, messages, seconds);
+}
+
+static int runGaussSeidel(FlatTables& tables, const vector<Node>& nodes, int method,
+                          uint64_t orderSeed, bool stopOnCountToInfinity,
+                          MetricsRecorder& metrics) {
+    int N = tables.N;
+    XorShift64 rng(orderSeed);
+    vector<int> order;
+    vector<int> rowDist(tables.row()), rowNext(tables.row());
+    vector<const int*> nbrDist, nbrNext;
+    long long messages = advertisementsPerRound(nodes, N);
+
+    for (int round = 1; ; ++round) {
+        auto start = chrono::steady_clock::now();
+        visitOrder(order, N, orderSeed ? &rng : nullptr);
+        bool changed = false;
+        bool overLimit = false;
+        for (int r : order) {
+            // Relax into a scratch row: the router's own row is one of its inputs
+            if (relaxFrom(tables, nodes, r, method, nbrDist, nbrNext, rowDist.data(), rowNext.data())) {
+                changed = true;
+            }
+            copy(rowDist.begin(), rowDist.end(), tables.distRow(r));
+            copy(rowNext.begin(), rowNext.end(), tables.nextRow(r));
+            overLimit = overLimit || overCountLimit(tables.distRow(r), N);
+        }
+        recordRound(metrics, tables, messages, secondsSince(start));
+        if (!changed || (stopOnCountToInfinity && overLimit)) return round;
+    }
+}
+
+static int runJacobi(FlatTables& tables, const vector<Node>& nodes, int method, int threads,
+                     bool stopOnCountToInfinity, MetricsRecorder& metrics) {
+    int N = tables.N;
+    threads = max(1, min(threads, N));
+    FlatTables nextTables = tables;
+    long long messages = advertisementsPerRound(nodes, N);
+
+    SpinBarrier barrier(threads);
+    atomic<int> changedFlag(0);
+    atomic<int> overFlag(0);
+    bool stop = false;
+    int rounds = 0;
+    auto start = chrono::steady_clock::now();
+
+    auto worker = [&](int t) {
+        int first = 1 + int((long long)N * t / threads);
+        int last = int((long long)N * (t + 1) / threads);
+        vector<const int*> nbrDist, nbrNext;
+        for (int round = 1; ; ++round) {
+            bool changed = false;
+            bool overLimit = false;
+            for (int r = first; r <= last; ++r) {
+                changed |= relaxFrom(tables, nodes, r, method, nbrDist, nbrNext,
+                                     nextTables.distRow(r), nextTables.nextRow(r));
+                overLimit = overLimit || overCountLimit(nextTables.distRow(r), N);
+            }
+            if (changed) changedFlag.store(1, memory_order_relaxed);
+            if (overLimit) overFlag.store(1, memory_order_relaxed);
+            barrier.wait();
+
+            // Thread 0 publishes the round while the others wait
+            if (t == 0) {
+                swap(tables.dist, nextTables.dist);
+                swap(tables.next, nextTables.next);
+                recordRound(metrics, tables, messages, secondsSince(start));
+                stop = !changedFlag.load(memory_order_relaxed) ||
+                       (stopOnCountToInfinity && overFlag.load(memory_order_relaxed));
+                changedFlag.store(0, memory_order_relaxed);
+                overFlag.store(0, memory_order_relaxed);
+                rounds = round;
+                start = chrono::steady_clock::now();
+            }
+            barrier.wait();
+            if (stop) break;
+        }
+    };
+
+    vector<thread> pool;
+    for (int t = 1; t < threads; ++t) {
+        pool.emplace_back(worker, t);
+    }
+    worker(0);
+    for (thread& th : pool) {
+        th.join();
+    }
+    return rounds;
+}
+
+int runSweep(FlatTables& tables, const vector<Node>& nodes, int method, SweepMode mode,
+             int threads, uint64_t orderSeed, bool stopOnCountToInfinity,
+             MetricsRecorder& metrics) {
+    if (mode == SWEEP_GAUSS_SEIDEL) {
+        return runGaussSeidel(tables, nodes, method, orderSeed, stopOnCountToInfinity, metrics);
+    }
+    return runJacobi(tables, nodes, method, threads, stopOnCountToInfinity, metrics);
+}
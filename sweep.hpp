@@ -0,0 +1,24 @@
+#ifndef SWEEP_HPP
+#define SWEEP_HPP
+#include "engine.hpp"
+#include <cstdint>
+
+class MetricsRecorder;
+
+// How a round reads its neighbours' vectors
+enum SweepMode {
+    SWEEP_JACOBI,         // Only the previous round: order-independent, parallel, deterministic
+    SWEEP_GAUSS_SEIDEL    // In place, in visit order: sequential, usually fewer rounds
+};
+
+// Runs DVR rounds over flat tables. Jacobi rounds are split across `threads`;
+// Gauss-Seidel visits routers in id order when orderSeed is 0, otherwise in a
+// seeded random order drawn afresh every round. Stops when no distance changes,
+// or, if stopOnCountToInfinity is set, when some cost passes the
+// count-to-infinity limit. Neighbours are taken from `nodes`.
+// Returns the number of rounds.
+int runSweep(FlatTables& tables, const std::vector<Node>& nodes, int method, SweepMode mode,
+             int threads, uint64_t orderSeed, bool stopOnCountToInfinity,
+             MetricsRecorder& metrics);
+
+#endif // SWEEP_HPP
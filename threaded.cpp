@@ -0,0 +1,166 @@
+#include "threaded.hpp"
+#include "barrier.hpp"
+#include "engine.hpp"
+#include "mailbox.hpp"
+#include "metrics.hpp"
+#include <memory>
+
+using namespace std;
+
+// Per-router state; only the thread owning the router touches it
+struct RouterState {
+    vector<int> dist, next;             // Current row
+    vector<int> newDist, newNext;       // Row being computed this round
+    vector<Mailbox*> outbox;            // One per entry of neighbors
+    vector<unique_ptr<Mailbox>> inbox;  // One per entry of neighbors
+    vector<Advert*> latest;             // Last advertisement received per inbox
+    vector<const int*> nbrDist, nbrNext;
+    unique_ptr<AdvertPool> pool;
+};
+
+int runThreaded(vector<Node>& nodes, int N, int method, int threads,
+                bool stopOnCountToInfinity, MetricsRecorder& metrics, MailboxStalls* stalls) {
+    threads = max(1, min(threads, N));
+    size_t row = N + 1;
+
+    FlatTables tables;
+    tables.load(nodes, N);
+    vector<RouterState> routers(N + 1);
+    for (int r = 1; r <= N; ++r) {
+        RouterState& state = routers[r];
+        state.dist.assign(tables.distRow(r), tables.distRow(r) + row);
+        state.next.assign(tables.nextRow(r), tables.nextRow(r) + row);
+        state.newDist.resize(row);
+        state.newNext.resize(row);
+        size_t degree = nodes[r].neighbors.size();
+        for (size_t k = 0; k < degree; ++k) {
+            state.inbox.emplace_back(new Mailbox());
+        }
+        state.latest.assign(degree, nullptr);
+        state.nbrDist.assign(degree, nullptr);
+        state.nbrNext.assign(degree, nullptr);
+        // One buffer in flight, one held by the receivers, one spare
+        state.pool.reset(new AdvertPool(3, N));
+    }
+
+    // Wire each neighbour entry of u to the matching inbox of v
+    vector<vector<int>> peer = pairNeighborEntries(nodes, N);
+    for (int u = 1; u <= N; ++u) {
+        for (size_t k = 0; k < peer[u].size(); ++k) {
+            routers[u].outbox.push_back(routers[nodes[u].neighbors[k]].inbox[peer[u][k]].get());
+        }
+    }
+
+    SpinBarrier barrier(threads);
+    atomic<int> changedFlag[2];
+    atomic<int> overFlag[2];
+    for (int p = 0; p < 2; ++p) {
+        changedFlag[p].store(0);
+        overFlag[p].store(0);
+    }
+    int rounds = 0;
+    long long messages = advertisementsPerRound(nodes, N);
+    vector<const int*> distRows(row), nextRows(row);
+    vector<MailboxStalls> threadStalls(threads);
+
+    auto worker = [&](int t) {
+        MailboxStalls waits;
+        int first = 1 + int((long long)N * t / threads);
+        int last = int((long long)N * (t + 1) / threads);
+        for (int round = 1; ; ++round) {
+            auto start = chrono::steady_clock::now();
+
+            // Publish: one shared advertisement per router, a pointer per link
+            for (int r = first; r <= last; ++r) {
+                RouterState& state = routers[r];
+                if (state.outbox.empty()) continue;
+                Advert* advert;
+                while ((advert = state.pool->acquire(state.outbox.size())) == nullptr) {
+                    waits.poolWaits++;
+                    this_thread::yield();
+                }
+                advert->round = round;
+                advert->sender = r;
+                copy(state.dist.begin(), state.dist.end(), advert->dist.begin());
+                copy(state.next.begin(), state.next.end(), advert->next.begin());
+                for (Mailbox* mailbox : state.outbox) {
+                    while (!mailbox->push(advert)) {
+                        waits.fullMailboxes++;
+                        this_thread::yield();
+                    }
+                }
+            }
+            waits.barrierYields += barrier.wait();
+
+            // Receive and relax
+            bool changed = false;
+            bool overLimit = false;
+            for (int r = first; r <= last; ++r) {
+                RouterState& state = routers[r];
+                for (size_t k = 0; k < state.inbox.size(); ++k) {
+                    Advert* advert = state.inbox[k]->pop();
+                    if (state.latest[k] != nullptr) state.latest[k]->release();
+                    state.latest[k] = advert;
+                    state.nbrDist[k] = advert->dist.data();
+                    state.nbrNext[k] = advert->next.data();
+                }
+                changed |= relaxRouter(r, N, method, nodes[r].neighbors,
+                                       state.dist.data(), state.next.data(),
+                                       state.nbrDist.data(), state.nbrNext.data(),
+                                       state.newDist.data(), state.newNext.data());
+                state.dist.swap(state.newDist);
+                state.next.swap(state.newNext);
+                for (int j = 1; j <= N; ++j) {
+                    if (state.dist[j] > COUNT_TO_INFINITY_LIMIT && state.dist[j] < INFINITY) {
+                        overLimit = true;
+                        break;
+                    }
+                }
+            }
+            if (changed) changedFlag[round & 1].store(1, memory_order_relaxed);
+            if (overLimit) overFlag[round & 1].store(1, memory_order_relaxed);
+            waits.barrierYields += barrier.wait();
+
+            bool stop = !changedFlag[round & 1].load(memory_order_relaxed) ||
+                        (stopOnCountToInfinity && overFlag[round & 1].load(memory_order_relaxed));
+            if (t == 0) {
+                // Nobody touches next round's flags, or swaps rows, before the next barrier
+                changedFlag[(round + 1) & 1].store(0, memory_order_relaxed);
+                overFlag[(round + 1) & 1].store(0, memory_order_relaxed);
+                rounds = round;
+                if (metrics.enabled()) {
+                    for (int i = 1; i <= N; ++i) {
+                        distRows[i] = routers[i].dist.data();
+                        nextRows[i] = routers[i].next.data();
+                    }
+                    metrics.recordRows(distRows, nextRows, N, messages, secondsSince(start));
+                }
+            }
+            if (stop) break;
+        }
+        threadStalls[t] = waits;
+    };
+
+    vector<thread> pool;
+    for (int t = 1; t < threads; ++t) {
+        pool.emplace_back(worker, t);
+    }
+    worker(0);
+    for (thread& th : pool) {
+        th.join();
+    }
+    if (stalls) {
+        for (const MailboxStalls& waits : threadStalls) {
+            stalls->poolWaits += waits.poolWaits;
+            stalls->fullMailboxes += waits.fullMailboxes;
+            stalls->barrierYields += waits.barrierYields;
+        }
+    }
+
+    for (int i = 1; i <= N; ++i) {
+        copy(routers[i].dist.begin(), routers[i].dist.end(), tables.distRow(i));
+        copy(routers[i].next.begin(), routers[i].next.end(), tables.nextRow(i));
+    }
+    tables.store(nodes);
+    return rounds;
+}
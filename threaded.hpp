@@ -0,0 +1,25 @@
+#ifndef THREADED_HPP
+#define THREADED_HPP
+#include "defs.hpp"
+
+class MetricsRecorder;
+
+// Times a thread had to wait, summed over all threads
+struct MailboxStalls {
+    long long poolWaits = 0;       // No free advertisement buffer: a neighbour still holds them
+    long long fullMailboxes = 0;   // Outgoing mailbox full: the neighbour has not drained it
+    long long barrierYields = 0;   // Threaded engine only: yields at the round barriers
+};
+
+// Runs DVR rounds on `threads` threads that exchange advertisements through
+// per-link lock-free mailboxes. Each router publishes one pooled, reference
+// counted advertisement per round that all of its neighbours read without
+// copying. Stops when no distance changes, or, if stopOnCountToInfinity is set,
+// when some cost passes the count-to-infinity limit. Per-round statistics go to
+// `metrics`, and the threads' waits to `stalls` if given. Returns the number
+// of rounds.
+int runThreaded(std::vector<Node>& nodes, int N, int method, int threads,
+                bool stopOnCountToInfinity, MetricsRecorder& metrics,
+                MailboxStalls* stalls = nullptr);
+
+#endif // THREADED_HPP
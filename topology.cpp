@@ -0,0 +1,55 @@
+#include "topology.hpp"
+#include <set>
+
+using namespace std;
+
+vector<Edge> randomTopology(int N, int M, int maxCost, uint64_t seed) {
+    XorShift64 rng(seed);
+    long long maxLinks = (long long)N * (N - 1) / 2;
+    M = int(max<long long>(N - 1, min<long long>(M, maxLinks)));
+
+    vector<Edge> edges;
+    set<pair<int, int>> used;
+    auto addLink = [&](int a, int b) {
+        if (a == b || !used.insert({min(a, b), max(a, b)}).second) return;
+        edges.push_back({a, b, 1 + rng.below(maxCost)});
+    };
+    for (int v = 2; v <= N; ++v) {
+        addLink(1 + rng.below(v - 1), v);
+    }
+    while ((int)edges.size() < M) {
+        addLink(1 + rng.below(N), 1 + rng.below(N));
+    }
+    return edges;
+}
+
+void buildNodes(vector<Node>& nodes, const vector<Edge>& edges, int N) {
+    nodes.assign(N + 1, Node());
+    for (int i = 1; i <= N; ++i) {
+        nodes[i].id = i;
+        for (int j = 1; j <= N; ++j) {
+            nodes[i].distanceVector[j] = i == j ? 0 : INFINITY;
+            nodes[i].nextHop[j] = i == j ? j : -1;
+        }
+    }
+    for (auto& edge : edges) {
+        nodes[edge.src].neighbors.push_back(edge.dest);
+        nodes[edge.dest].neighbors.push_back(edge.src);
+        nodes[edge.src].distanceVector[edge.dest] = edge.cost;
+        nodes[edge.src].nextHop[edge.dest] = edge.dest;
+        nodes[edge.dest].distanceVector[edge.src] = edge.cost;
+        nodes[edge.dest].nextHop[edge.src] = edge.src;
+    }
+}
+
+void visitOrder(vector<int>& order, int N, XorShift64* rng) {
+    order.resize(N);
+    for (int i = 0; i < N; ++i) {
+        order[i] = i + 1;
+    }
+    if (rng == nullptr) return;
+    // Fisher-Yates
+    for (int i = N - 1; i > 0; --i) {
+        swap(order[i], order[rng->below(i + 1)]);
+    }
+}
@@ -0,0 +1,36 @@
+#ifndef TOPOLOGY_HPP
+#define TOPOLOGY_HPP
+#include "defs.hpp"
+#include <cstdint>
+
+// Small deterministic generator (xorshift64) so runs replay from a seed
+struct XorShift64 {
+    uint64_t state;
+
+    explicit XorShift64(uint64_t seed) : state(seed ? seed : 0x9E3779B97F4A7C15ull) {}
+
+    uint64_t next() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+
+    // Uniform-enough integer in [0, n)
+    int below(int n) { return int(next() % uint64_t(n)); }
+};
+
+// Connected random topology on routers 1..N with M links (at least N - 1) and
+// costs in 1..maxCost: a random spanning tree plus random extra links,
+// without parallel links or self-loops.
+std::vector<Edge> randomTopology(int N, int M, int maxCost, uint64_t seed);
+
+// Builds neighbours and initial distance vectors for a topology, like
+// initializeNodes and initializeDistanceVectors in the parts
+void buildNodes(std::vector<Node>& nodes, const std::vector<Edge>& edges, int N);
+
+// Fills `order` with routers 1..N: in id order without a generator, otherwise
+// shuffled by it
+void visitOrder(std::vector<int>& order, int N, XorShift64* rng);
+
+#endif // TOPOLOGY_HPP
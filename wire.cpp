@@ -0,0 +1,256 @@
+#include "wire.hpp"
+#include "engine.hpp"
+#include "metrics.hpp"
+#include <cstring>
+
+using namespace std;
+
+static void putVarint(vector<uint8_t>& out, uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back(uint8_t(value) | 0x80);
+        value >>= 7;
+    }
+    out.push_back(uint8_t(value));
+}
+
+static int varintSize(uint32_t value) {
+    int bytes = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        bytes++;
+    }
+    return bytes;
+}
+
+static bool getVarint(const uint8_t* data, size_t size, size_t& pos, uint32_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (pos >= size) return false;
+        uint8_t byte = data[pos++];
+        value |= uint32_t(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+static uint32_t zigzag(int value) {
+    return (uint32_t(value) << 1) ^ uint32_t(value >> 31);
+}
+
+static int unzigzag(uint32_t value) {
+    return int(value >> 1) ^ -int(value & 1);
+}
+
+void encodeAdvert(const int* prev, const int* cur, int N, vector<uint8_t>& out) {
+    vector<int> changed;
+    int gapBytes = 0;
+    for (int j = 1; j <= N; ++j) {
+        if (cur[j] != prev[j]) {
+            gapBytes += varintSize(j - (changed.empty() ? 0 : changed.back()));
+            changed.push_back(j);
+        }
+    }
+    int bitmapBytes = (N + 7) / 8;
+    bool gapList = gapBytes < bitmapBytes;
+
+    putVarint(out, uint32_t(changed.size()) << 1 | (gapList ? 1 : 0));
+    if (changed.empty()) return;
+    if (gapList) {
+        int last = 0;
+        for (int j : changed) {
+            putVarint(out, j - last);
+            last = j;
+        }
+    } else {
+        size_t start = out.size();
+        out.resize(start + bitmapBytes, 0);
+        for (int j : changed) {
+            out[start + (j - 1) / 8] |= uint8_t(1 << ((j - 1) % 8));
+        }
+    }
+    for (int j : changed) {
+        putVarint(out, zigzag(cur[j] - prev[j]));
+    }
+}
+
+long decodeAdvert(const uint8_t* data, size_t size, int* vec, int N) {
+    size_t pos = 0;
+    uint32_t header;
+    if (!getVarint(data, size, pos, header)) return -1;
+    uint32_t count = header >> 1;
+    if (count > uint32_t(N)) return -1;
+    if (count == 0) return pos;
+
+    vector<int> changed;
+    changed.reserve(count);
+    if (header & 1) {
+        int last = 0;
+        for (uint32_t k = 0; k < count; ++k) {
+            uint32_t gap;
+            if (!getVarint(data, size, pos, gap) || gap == 0 || gap > uint32_t(N - last)) return -1;
+            last += gap;
+            changed.push_back(last);
+        }
+    } else {
+        size_t bitmapBytes = (N + 7) / 8;
+        if (size - pos < bitmapBytes) return -1;
+        for (int j = 1; j <= N; ++j) {
+            if (data[pos + (j - 1) / 8] & (1 << ((j - 1) % 8))) changed.push_back(j);
+        }
+        pos += bitmapBytes;
+        if (changed.size() != count) return -1;
+    }
+    for (int j : changed) {
+        uint32_t delta;
+        if (!getVarint(data, size, pos, delta)) return -1;
+        vec[j] += unzigzag(delta);
+    }
+    return pos;
+}
+
+int runWire(vector<Node>& nodes, int N, int method, const string& reportPrefix,
+            bool stopOnCountToInfinity, MetricsRecorder& metrics) {
+    size_t row = N + 1;
+
+    // One link per neighbour entry, numbered by sender
+    vector<int> linkStart(N + 2, 0);
+    for (int u = 1; u <= N; ++u) {
+        linkStart[u + 1] = linkStart[u] + nodes[u].neighbors.size();
+    }
+    int links = linkStart[N + 1];
+
+    // For each receiver entry, the link that feeds it
+    vector<vector<int>> peer = pairNeighborEntries(nodes, N);
+    vector<vector<int>> inLink(N + 1);
+    for (int v = 1; v <= N; ++v) {
+        inLink[v].resize(nodes[v].neighbors.size());
+    }
+    for (int u = 1; u <= N; ++u) {
+        for (size_t k = 0; k < peer[u].size(); ++k) {
+            inLink[nodes[u].neighbors[k]][peer[u][k]] = linkStart[u] + k;
+        }
+    }
+
+    FlatTables tables;
+    tables.load(nodes, N);
+    vector<int>& dist = tables.dist;
+    vector<int>& next = tables.next;
+    vector<int> newDist(row * row), newNext(row * row);
+    vector<int> lastSent(size_t(links) * row, INFINITY);
+    vector<int> lastReceived(size_t(links) * row, INFINITY);
+    vector<int> advert(row, INFINITY);
+    vector<int> noNextHops(row, -1);
+    vector<vector<uint8_t>> buffers(links);
+    vector<long long> linkBytes(links, 0);
+    vector<const int*> distRows(row), nextRows(row);
+    for (int i = 1; i <= N; ++i) {
+        distRows[i] = &dist[i * row];
+        nextRows[i] = &next[i * row];
+    }
+
+    ofstream roundsFile(reportPrefix + "_rounds.csv");
+    if (!roundsFile.is_open()) {
+        cerr << "Error opening file " << reportPrefix << "_rounds.csv\n";
+        return -1;
+    }
+    roundsFile << "round,messages,bytes,full_bytes,changed_routers\n";
+
+    long long totalBytes = 0;
+    long long totalMessages = 0;
+    int round = 0;
+    while (true) {
+        ++round;
+        auto start = chrono::steady_clock::now();
+
+        // Send: filter for the receiving neighbour, then delta-encode
+        long long roundBytes = 0;
+        for (int u = 1; u <= N; ++u) {
+            const int* selfDist = &dist[u * row];
+            const int* selfNext = &next[u * row];
+            for (size_t k = 0; k < nodes[u].neighbors.size(); ++k) {
+                int v = nodes[u].neighbors[k];
+                int link = linkStart[u] + k;
+                for (int j = 1; j <= N; ++j) {
+                    advert[j] = advertisedCost(v, j, selfDist[j], selfNext[j], method);
+                }
+                int* sent = &lastSent[size_t(link) * row];
+                buffers[link].clear();
+                encodeAdvert(sent, advert.data(), N, buffers[link]);
+                memcpy(sent + 1, advert.data() + 1, N * sizeof(int));
+                linkBytes[link] += buffers[link].size();
+                roundBytes += buffers[link].size();
+            }
+        }
+
+        // Receive: decode into the per-link copy and relax. The vectors are
+        // already filtered by the sender, so they are relaxed with method 1
+        // (a withheld entry arrives as -1 and is skipped). Next hops do not
+        // travel on the wire: every neighbour's next-hop row reads as -1.
+        bool changed = false;
+        bool overLimit = false;
+        int changedRouters = 0;
+        vector<const int*> nbrDist, nbrNext;
+        for (int v = 1; v <= N; ++v) {
+            nbrDist.clear();
+            nbrNext.assign(inLink[v].size(), noNextHops.data());
+            for (int link : inLink[v]) {
+                int* received = &lastReceived[size_t(link) * row];
+                long used = decodeAdvert(buffers[link].data(), buffers[link].size(), received, N);
+                if (used != long(buffers[link].size())) {
+                    cerr << "Malformed advertisement on link into router " << v << "\n";
+                    return -1;
+                }
+                nbrDist.push_back(received);
+            }
+            if (relaxRouter(v, N, 1, nodes[v].neighbors, &dist[v * row], &next[v * row],
+                            nbrDist.data(), nbrNext.data(), &newDist[v * row], &newNext[v * row])) {
+                changed = true;
+                changedRouters++;
+            }
+        }
+        for (int v = 1; v <= N; ++v) {
+            memcpy(&dist[v * row], &newDist[v * row], row * sizeof(int));
+            memcpy(&next[v * row], &newNext[v * row], row * sizeof(int));
+            for (int j = 1; j <= N; ++j) {
+                if (dist[v * row + j] > COUNT_TO_INFINITY_LIMIT && dist[v * row + j] < INFINITY) {
+                    overLimit = true;
+                }
+            }
+        }
+
+        metrics.recordRows(distRows, nextRows, N, links, secondsSince(start));
+
+        // An uncompressed advertisement is N (destination, cost) pairs of ints
+        roundsFile << round << "," << links << "," << roundBytes << ","
+                   << (long long)links * N * 2 * sizeof(int) << "," << changedRouters << "\n";
+        totalBytes += roundBytes;
+        totalMessages += links;
+
+        if (!changed || (stopOnCountToInfinity && overLimit)) break;
+    }
+    roundsFile.close();
+
+    ofstream linksFile(reportPrefix + "_links.csv");
+    if (!linksFile.is_open()) {
+        cerr << "Error opening file " << reportPrefix << "_links.csv\n";
+        return -1;
+    }
+    linksFile << "from,to,messages,bytes,bytes_per_round\n";
+    for (int u = 1; u <= N; ++u) {
+        for (size_t k = 0; k < nodes[u].neighbors.size(); ++k) {
+            int link = linkStart[u] + k;
+            linksFile << u << "," << nodes[u].neighbors[k] << "," << round << ","
+                      << linkBytes[link] << "," << linkBytes[link] / round << "\n";
+        }
+    }
+    linksFile.close();
+
+    long long fullBytes = totalMessages * N * 2 * sizeof(int);
+    // A summary on stderr, so the part's stdout stays comparable with other engines
+    cerr << "Wire traffic: " << totalBytes << " bytes in " << totalMessages << " messages over "
+         << round << " rounds (" << (fullBytes ? totalBytes * 100 / fullBytes : 0)
+         << "% of uncompressed vectors)\n";
+
+    tables.store(nodes);
+    return round;
+}
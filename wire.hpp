@@ -0,0 +1,31 @@
+#ifndef WIRE_HPP
+#define WIRE_HPP
+#include "defs.hpp"
+#include <cstdint>
+
+class MetricsRecorder;
+
+// Wire format of one advertisement on one link, relative to the previous
+// vector sent on that link (initially all INFINITY):
+//   varint  header = changed count << 1 | gap-list flag
+//   changed destinations, either as a bitmap of N bits or, when that is
+//   smaller, as varint gaps between ascending destination ids
+//   one zigzag varint cost delta per changed destination
+// A withheld entry (split horizon) travels as cost -1.
+
+// Encodes `cur` against `prev` (both indexed 1..N) and appends it to `out`
+void encodeAdvert(const int* prev, const int* cur, int N, std::vector<uint8_t>& out);
+
+// Applies an encoded advertisement to `vec` in place. Returns the number of
+// bytes consumed, or -1 if the buffer is malformed.
+long decodeAdvert(const uint8_t* data, size_t size, int* vec, int N);
+
+// Runs DVR rounds where every advertisement is sent as an encoded byte buffer
+// per link. Per-round and per-link traffic is written to
+// <reportPrefix>_rounds.csv and <reportPrefix>_links.csv. Stops like the
+// other engines and records per-round statistics to `metrics`.
+// Returns the number of rounds, or -1 on error.
+int runWire(std::vector<Node>& nodes, int N, int method, const std::string& reportPrefix,
+            bool stopOnCountToInfinity, MetricsRecorder& metrics);
+
+#endif // WIRE_HPP